@@ -60,6 +60,12 @@ include(src/tools/tools.pri)
 include(src/desktop/desktop.pri)
 include(src/web/web.pri)
 include(src/singleapplication/singleapplication.pri)
+
+# optional benchmark suite, build with "qmake CONFIG+=benchmark"
+benchmark {
+    DEFINES += UB_BENCHMARK
+    include(src/benchmark/benchmark.pri)
+}
 DEFINES += QAPPLICATION_CLASS=QApplication
 
 DEPENDPATH += src/pdf-merger
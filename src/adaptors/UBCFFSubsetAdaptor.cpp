@@ -145,17 +145,11 @@ bool UBCFFSubsetAdaptor::ConvertCFFFileToUbz(QString &cffSourceFile, std::shared
 }
 UBCFFSubsetAdaptor::UBCFFSubsetReader::UBCFFSubsetReader(std::shared_ptr<UBDocumentProxy>proxy, QFile *content)
     : mProxy(proxy)
+    , mContent(content)
+    , mCurrentSceneIndex(0)
     , mGSectionContainer(NULL)
 {
-    int errorLine, errorColumn;
-    QString errorStr;
-    if(!mDOMdoc.setContent(content, true, &errorStr, &errorLine, &errorColumn)){
-        qWarning() << "Error:Parseerroratline" << errorLine << ","
-                  << "column" << errorColumn << ":" << errorStr;
-    } else {
-        qDebug() << "well parsed to DOM";
-        pwdContent = QFileInfo(content->fileName()).dir().absolutePath();
-    }
+    pwdContent = QFileInfo(content->fileName()).dir().absolutePath();
     qDebug() << "tmp path is" << pwdContent;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parse()
@@ -163,19 +157,15 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parse()
     UBMetadataDcSubsetAdaptor::persist(mProxy);
 
     mIndent = "";
-    if (!getTempFileName() || !createTempFlashPath())
+    if (!createTempFlashPath())
         return false;
 
-    if (mDOMdoc.isNull())
-        return false;
+    QDir().mkpath(mProxy->persistencePath() + "/" + UBPersistenceManager::imageDirectory);
 
     bool result = parseDoc();
     if (result)
         result = mProxy->pageCount() != 0;
 
-    if (QFile::exists(mTempFilePath))
-        QFile::remove(mTempFilePath);
-
 //    if (mTmpFlashDir.exists())
 //        UBFileSystemUtils::deleteDir(mTmpFlashDir.path());
 
@@ -237,7 +227,7 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgRect(const QDomElement &elem
     width += strokeWidth;
     height += strokeWidth;
 
-    //init svg generator with temp file
+    //init svg generator with in-memory output
     QSvgGenerator *generator = createSvgGenerator(width, height);
 
     //init painter to paint to svg
@@ -261,11 +251,9 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgRect(const QDomElement &elem
 
     painter.end();
 
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
-   
     QString uuid = QUuid::createUuid().toString();
     mRefToUuidMap.insert(element.attribute(aId), uuid);
-    svgItem->setUuid(QUuid(uuid));
+    UBGraphicsSvgItem *svgItem = addSvgShape(QUuid(uuid));
 
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
@@ -316,11 +304,9 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgEllipse(const QDomElement &e
 
     painter.end();
 
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
-
     QString uuid = QUuid::createUuid().toString();
     mRefToUuidMap.insert(element.attribute(aId), uuid);
-    svgItem->setUuid(QUuid(uuid));
+    UBGraphicsSvgItem *svgItem = addSvgShape(QUuid(uuid));
 
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
@@ -424,7 +410,7 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolygon(const QDomElement &e
         QSvgGenerator *generator = createSvgGenerator(width + pen.width(), height + pen.width());
         QPainter painter;
 
-        painter.begin(generator); //drawing to svg tmp file
+        painter.begin(generator); //drawing to in-memory svg
 
         painter.translate(pen.widthF() / 2 - x1, pen.widthF() / 2 - y1);
         painter.setBrush(brush);
@@ -433,14 +419,13 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolygon(const QDomElement &e
 
         painter.end();
 
-        //add resulting svg file to scene
-        UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+        //add resulting svg to scene
         QTransform transform;
         QString textTransform = element.attribute(aTransform);
         
         QUuid uuid = QUuid::createUuid();
         mRefToUuidMap.insert(element.attribute(aId), uuid.toString());
-        svgItem->setUuid(uuid);
+        UBGraphicsSvgItem *svgItem = addSvgShape(uuid);
 
         svgItem->resetTransform();
         if (!textTransform.isNull()) {
@@ -543,7 +528,7 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolyline(const QDomElement &
         QSvgGenerator *generator = createSvgGenerator(width + pen.width(), height + pen.width());
         QPainter painter;
 
-        painter.begin(generator); //drawing to svg tmp file
+        painter.begin(generator); //drawing to in-memory svg
 
         painter.translate(pen.widthF() / 2 - x1, pen.widthF() / 2 - y1);
         painter.setBrush(brush);
@@ -552,12 +537,10 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolyline(const QDomElement &
 
         painter.end();
 
-        //add resulting svg file to scene
-        UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
-        
+        //add resulting svg to scene
         QString uuid = QUuid::createUuid().toString();
         mRefToUuidMap.insert(element.attribute(aId), uuid);
-        svgItem->setUuid(QUuid(uuid));
+        UBGraphicsSvgItem *svgItem = addSvgShape(QUuid(uuid));
 
         QTransform transform;
         QString textTransform = element.attribute(aTransform);
@@ -713,12 +696,10 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgText(const QDomElement &elem
 
     painter.end();
 
-    //add resulting svg file to scene
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
-
+    //add resulting svg to scene
     QString uuid = QUuid::createUuid().toString();
     mRefToUuidMap.insert(element.attribute(aId), uuid);
-    svgItem->setUuid(QUuid(uuid));
+    UBGraphicsSvgItem *svgItem = addSvgShape(QUuid(uuid));
 
     svgItem->resetTransform();
     repositionSvgItem(svgItem, width, height, x + transform.m31(), y + transform.m32(), transform);
@@ -1074,11 +1055,11 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgVideo(const QDomElement &ele
     return true;
 }
 
-void UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgSectionAttr(const QDomElement &svgSection)
+void UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgSectionAttr(const QXmlStreamAttributes &svgSection)
 {
-    getViewBoxDimenstions(svgSection.attribute(aViewbox));
-    mSize = QSize(svgSection.attribute(aWidth).toInt(),
-                  svgSection.attribute(aHeight).toInt());
+    getViewBoxDimenstions(svgSection.value(aViewbox).toString());
+    mSize = QSize(svgSection.value(aWidth).toInt(),
+                  svgSection.value(aHeight).toInt());
 }
 
 void UBCFFSubsetAdaptor::UBCFFSubsetReader::addItemToGSection(QGraphicsItem *item)
@@ -1088,10 +1069,10 @@ void UBCFFSubsetAdaptor::UBCFFSubsetReader::addItemToGSection(QGraphicsItem *ite
 
 void UBCFFSubsetAdaptor::UBCFFSubsetReader::hashSceneItem(const QDomElement &element, UBGraphicsItem *item)
 {
-//    adding element pointer to hash to refer if needed
+//    the page is released once parsed, so the iwb element referring to the item is applied right away
     QString key = element.attribute(aId);
-    if (!key.isNull()) {
-        persistedItems.insert(key, item);
+    if (!key.isNull() && mIwbElements.contains(key)) {
+        parseIwbElement(mIwbElements.value(key), item);
     }
 }
 
@@ -1119,26 +1100,36 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgElement(const QDomElement &p
     return true;
 }
 
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPage(const QDomElement &parent)
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPage(QXmlStreamReader &reader, bool atFirstElement)
 {
     createNewScene();
-    QDomElement currentSvgElement = parent.firstChildElement();
-    while (!currentSvgElement.isNull()) {
-        if (!parseSvgElement(currentSvgElement))
+
+    // only the element being imported is held as DOM
+    bool hasElement = atFirstElement || reader.readNextStartElement();
+    while (hasElement) {
+        QDomDocument fragment;
+        QDomElement currentSvgElement = readDomElement(reader, fragment);
+
+        if (!parseSvgElement(currentSvgElement)) {
+            skipRemainingElements(reader);
             return false;
+        }
 
-        currentSvgElement = currentSvgElement.nextSiblingElement();
+        hasElement = reader.readNextStartElement();
     }
 
     return true;
 }
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPageset(const QDomElement &parent)
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPageset(QXmlStreamReader &reader)
 {
-    QDomElement currentPage = parent.firstChildElement(tPage);
-    while (!currentPage.isNull()) {
-        if (!parseSvgPage(currentPage))
+    while (reader.readNextStartElement()) {
+        if (reader.name() != tPage) {
+            reader.skipCurrentElement();
+        }
+        else if (!parseSvgPage(reader)) {
+            skipRemainingElements(reader);
             return false;
-        currentPage = currentPage.nextSiblingElement(tPage);
+        }
     }
     return true;
 }
@@ -1152,20 +1143,22 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbMeta(const QDomElement &elem
 
     return true;
 }
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvg(const QDomElement &svgSection)
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvg(QXmlStreamReader &reader)
 {
-    if (svgSection.namespaceURI() != svgNS) {
+    if (reader.namespaceUri() != svgNS) {
         qWarning() << "incorrect svg namespace, incorrect document";
        // return false;
     }
 
-    parseSvgSectionAttr(svgSection);
-    QDomElement currentSvg = svgSection.firstChildElement();
+    parseSvgSectionAttr(reader.attributes());
 
-    if (currentSvg.tagName() != tPageset) {
-        parseSvgPage(svgSection);
-    } else if (currentSvg.tagName() == tPageset){
-        parseSvgPageset(currentSvg);
+    if (!reader.readNextStartElement()) {
+        createNewScene();
+    } else if (reader.name() != tPageset) {
+        parseSvgPage(reader, true);
+    } else {
+        parseSvgPageset(reader);
+        skipRemainingElements(reader);
     }
 
     return true;
@@ -1268,7 +1261,7 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::strToBool(QString str)
     return str == "true";
 }
 
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbElement(QDomElement &element)
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbElement(const QDomElement &element, UBGraphicsItem *referedItem)
 {
     if (element.namespaceURI() != iwbNS) {
         qWarning() << "incorrect iwb element namespace, incorrect document";
@@ -1279,48 +1272,120 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseIwbElement(QDomElement &element
     bool isEditableItem = false;
     bool isEditable = false; //Text items to convert to UBGraphicsTextItem only
 
-    QString IDRef = element.attribute(aRef);
-    if (!IDRef.isNull()) {
-        element.hasAttribute(aBackground) ? strToBool(element.attribute(aBackground)) : false;
-        locked = element.hasAttribute(aBackground) ? strToBool(element.attribute(aBackground)) : false;
-        isEditableItem = element.hasAttribute(aEditable);
-        if (isEditableItem)
-            isEditable = strToBool(element.attribute(aEditable));
-
-        UBGraphicsItem *referedItem(0);
-        QHash<QString, UBGraphicsItem*>::iterator iReferedItem;
-        iReferedItem = persistedItems.find(IDRef);
-        if (iReferedItem != persistedItems.end()) {
-            referedItem = *iReferedItem;
-            referedItem->Delegate()->lock(locked);
+    locked = element.hasAttribute(aBackground) ? strToBool(element.attribute(aBackground)) : false;
+    isEditableItem = element.hasAttribute(aEditable);
+    if (isEditableItem)
+        isEditable = strToBool(element.attribute(aEditable));
+
+    referedItem->Delegate()->lock(locked);
+
+    if (isEditableItem) {
+        UBGraphicsTextItemDelegate *textDelegate = dynamic_cast<UBGraphicsTextItemDelegate*>(referedItem->Delegate());
+        if (textDelegate) {
+            textDelegate->setEditable(isEditable);
         }
-        if (isEditableItem) {
-            UBGraphicsTextItemDelegate *textDelegate = dynamic_cast<UBGraphicsTextItemDelegate*>(referedItem->Delegate());
-            if (textDelegate) {
-                textDelegate->setEditable(isEditable);
+    }
+
+    return true;
+}
+bool UBCFFSubsetAdaptor::UBCFFSubsetReader::hashIwbElements()
+{
+    // element sections follow the pages they refer to, they are collected before the pages are parsed
+    QXmlStreamReader reader(mContent);
+
+    if (reader.readNextStartElement()) {
+        while (reader.readNextStartElement()) {
+            if (reader.name() != tElement) {
+                reader.skipCurrentElement();
+                continue;
             }
+
+            QDomElement element = readDomElement(reader, mIwbElementsDocument);
+            QString ref = element.attribute(aRef);
+            if (!ref.isNull())
+                mIwbElements.insert(ref, element);
         }
     }
 
-    return true;
+    return mContent->seek(0);
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseDoc()
 {
-    QDomElement currentTopElement = mDOMdoc.documentElement().firstChildElement();
-    while (!currentTopElement.isNull()) {
-        QString tagName = currentTopElement.tagName();
-        if      (tagName == tMeta       && !parseIwbMeta(currentTopElement))    return false;
-        else if (tagName == tSvg        && !parseSvg(currentTopElement))        return false;
-        else if (tagName == tGroup      && !parseIwbGroup(currentTopElement))   return false;
-        else if (tagName == tElement    && !parseIwbElement(currentTopElement)) return false;
+    if (!hashIwbElements()) return false;
+
+    // the document is streamed, pages are read element by element and iwb sections one at a time
+    QXmlStreamReader reader(mContent);
 
-        currentTopElement = currentTopElement.nextSiblingElement();
+    if (reader.readNextStartElement()) {
+        while (reader.readNextStartElement()) {
+            QString tagName = reader.name().toString();
+
+            if (tagName == tSvg) {
+                if (!parseSvg(reader)) return false;
+            }
+            else if (tagName == tMeta || tagName == tGroup) {
+                QDomDocument fragment;
+                QDomElement currentTopElement = readDomElement(reader, fragment);
+
+                if      (tagName == tMeta       && !parseIwbMeta(currentTopElement))    return false;
+                else if (tagName == tGroup      && !parseIwbGroup(currentTopElement))   return false;
+            }
+            else {
+                reader.skipCurrentElement();
+            }
+        }
+    }
+
+    if (reader.hasError()) {
+        qWarning() << "Error:Parseerroratline" << reader.lineNumber() << ","
+                  << "column" << reader.columnNumber() << ":" << reader.errorString();
+        return false;
+    }
+
+    if (!mProxy->pageCount()) {
+        qDebug() << "No pages created";
+        return false;
     }
-    if (!persistScenes()) return false;
+
+    // the last page is complete once the iwb groups referring to it are parsed
+    if (!persistCurrentScene()) return false;
 
     return true;
 }
 
+QDomElement UBCFFSubsetAdaptor::UBCFFSubsetReader::readDomElement(QXmlStreamReader &reader, QDomDocument &document)
+{
+    // builds the current element and its content the way QDomDocument::setContent() does with namespace processing
+    QDomElement element = document.createElementNS(reader.namespaceUri().toString(), reader.qualifiedName().toString());
+
+    if (document.documentElement().isNull())
+        document.appendChild(element);
+
+    foreach (const QXmlStreamAttribute &attribute, reader.attributes())
+        element.setAttributeNS(attribute.namespaceUri().toString(), attribute.qualifiedName().toString(), attribute.value().toString());
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+
+        if (reader.isEndElement())
+            break;
+        else if (reader.isStartElement())
+            element.appendChild(readDomElement(reader, document));
+        else if (reader.isCDATA())
+            element.appendChild(document.createCDATASection(reader.text().toString()));
+        else if (reader.isCharacters() && !reader.isWhitespace())
+            element.appendChild(document.createTextNode(reader.text().toString()));
+    }
+
+    return element;
+}
+
+void UBCFFSubsetAdaptor::UBCFFSubsetReader::skipRemainingElements(QXmlStreamReader &reader)
+{
+    while (reader.readNextStartElement())
+        reader.skipCurrentElement();
+}
+
 void UBCFFSubsetAdaptor::UBCFFSubsetReader::repositionSvgItem(QGraphicsItem *item, qreal width, qreal height,
                                                               qreal x, qreal y,
                                                               QTransform &transform)
@@ -1354,7 +1419,12 @@ void UBCFFSubsetAdaptor::UBCFFSubsetReader::repositionSvgItem(QGraphicsItem *ite
 
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::createNewScene()
 {
-    mCurrentScene = UBPersistenceManager::persistenceManager()->createDocumentSceneAt(mProxy, mProxy->pageCount(), false);
+    // only one page is held in memory, the previous one is complete when the next one starts
+    if (!persistCurrentScene())
+        return false;
+
+    mCurrentSceneIndex = mProxy->pageCount();
+    mCurrentScene = UBPersistenceManager::persistenceManager()->createDocumentSceneAt(mProxy, mCurrentSceneIndex, false, false);
     mCurrentScene->setSceneRect(mViewBox);
     if ((mCurrentScene->sceneRect().topLeft().x() >= 0) || (mCurrentScene->sceneRect().topLeft().y() >= 0)) {
         mShiftVector = -mViewBox.center();
@@ -1367,36 +1437,14 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::createNewScene()
 
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::persistCurrentScene()
 {
-    if (mCurrentScene != 0 && mCurrentScene->isModified())
+    if (mCurrentScene)
     {
-        UBThumbnailAdaptor::persistScene(mProxy, mCurrentScene, mProxy->pageCount() - 1);
-        UBSvgSubsetAdaptor::persistScene(mProxy, mCurrentScene, mProxy->pageCount() - 1);
-
-        mCurrentScene->setModified(false);
-        mCurrentScene = 0;
-    }
-    return true;
-}
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::persistScenes()
-{
-    if (!mProxy->pageCount()) {
-        qDebug() << "No pages created";
-        return false;
-    }
-    for (int i = 0; i < mProxy->pageCount(); i++) {
-        mCurrentScene = UBPersistenceManager::persistenceManager()->getDocumentScene(mProxy, i);
-        if (!mCurrentScene) {
-            qDebug() << "can't allocate scene, loading failed";
-            return false;
-        }
+        UBSvgSubsetAdaptor::persistScene(mProxy, mCurrentScene, mCurrentSceneIndex);
+        UBThumbnailAdaptor::persistScene(mProxy, mCurrentScene, mCurrentSceneIndex, true);
 
-        UBSvgSubsetAdaptor::persistScene(mProxy, mCurrentScene, i);
-        std::shared_ptr<UBGraphicsScene> tmpScene = UBSvgSubsetAdaptor::loadScene(mProxy, i);
-        tmpScene->setModified(true);
-        UBThumbnailAdaptor::persistScene(mProxy, tmpScene, i);
         mCurrentScene->setModified(false);
+        mCurrentScene = nullptr;
     }
-
     return true;
 }
 
@@ -1504,36 +1552,42 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::getViewBoxDimenstions(const QString&
 
 QSvgGenerator* UBCFFSubsetAdaptor::UBCFFSubsetReader::createSvgGenerator(qreal width, qreal height)
 {
+    // shapes are painted in memory, see addSvgShape()
+    mSvgBuffer.close();
+    mSvgBuffer.setData(QByteArray());
+    mSvgBuffer.open(QIODevice::WriteOnly);
+
     QSvgGenerator* generator = new QSvgGenerator();
-//    qWarning() << QString("Making generator with file %1, size (%2, %3) and viewbox (%4 %5 %6 %7)").arg(mTempFilePath)
-//        .arg(width).arg(height).arg(0.0).arg(0.0).arg(width).arg(width);
     generator->setResolution(UBApplication::displayManager->logicalDpi(ScreenRole::Control));
-    generator->setFileName(mTempFilePath);
+    generator->setOutputDevice(&mSvgBuffer);
     generator->setSize(QSize(width, height));
     generator->setViewBox(QRectF(0, 0, width, height));
 
     return generator;
 }
 
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::getTempFileName()
+UBGraphicsSvgItem* UBCFFSubsetAdaptor::UBCFFSubsetReader::addSvgShape(const QUuid &uuid)
 {
-    int tmpNumber = 0;
-    QDir rootDir;
-    while (true)
-    {
-        mTempFilePath = QString("%1/sanksvg%2.%3")
-                .arg(rootDir.tempPath())
-                .arg(QDateTime::currentDateTime().toString("dd_MM_yyyy_HH-mm"))
-                .arg(tmpNumber);
-        if (!QFile::exists(mTempFilePath))
-            return true;
-        tmpNumber++;
-        if (tmpNumber == 100000)
-        {
-            qWarning() << "Import failed. Failed to create temporary file for svg objects";
-            return false;
-        }
+    // the svg data is written once, to the file the page links to
+    const QByteArray svgData = mSvgBuffer.data();
+
+    UBGraphicsSvgItem *svgItem = new UBGraphicsSvgItem(svgData);
+    svgItem->setFlag(QGraphicsItem::ItemIsMovable, true);
+    svgItem->setFlag(QGraphicsItem::ItemIsSelectable, true);
+    svgItem->setUuid(uuid);
+
+    mCurrentScene->addItem(svgItem);
+
+    QFile file(mProxy->persistencePath() + "/" + UBPersistenceManager::imageDirectory + "/" + uuid.toString() + ".svg");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(svgData);
+        file.close();
     }
+    else {
+        qWarning() << "cannot open file for writing embeded svg content " << file.fileName();
+    }
+
+    return svgItem;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::createTempFlashPath()
 {
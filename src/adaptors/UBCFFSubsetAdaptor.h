@@ -33,6 +33,8 @@
 #include <QString>
 #include <QStack>
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QBuffer>
 #include <QHash>
 
 class UBDocumentProxy;
@@ -70,8 +72,10 @@ private:
         bool parse();
 
     private:
-        QString mTempFilePath;
+        QFile *mContent;
+        QBuffer mSvgBuffer;
         std::shared_ptr<UBGraphicsScene> mCurrentScene;
+        int mCurrentSceneIndex;
         QRectF mCurrentSceneRect;
         QString mIndent;
         QRectF mViewBox;
@@ -84,25 +88,25 @@ private:
         UBGraphicsGroupContainerItem *mGSectionContainer;
 
     private:
-        QDomDocument mDOMdoc;
-        QDomNode mCurrentDOMElement;
-        QHash<QString, UBGraphicsItem*> persistedItems;
+        QDomDocument mIwbElementsDocument;
+        QHash<QString, QDomElement> mIwbElements;
         QMap<QString, QString> mRefToUuidMap;
         QDir mTmpFlashDir;
 
         void addItemToGSection(QGraphicsItem *item);
         bool hashElements();
+        bool hashIwbElements();
         void addExtentionsToHash(QDomElement *parent, QDomElement *topGroup);
 
         void hashSvg(QDomNode *parent, QString prefix = "");
         void hashSiblingIwbElements(QDomElement *parent, QDomElement *topGroup = 0);
 
-        inline void parseSvgSectionAttr(const QDomElement &);
-        bool parseSvgPage(const QDomElement &parent);
-        bool parseSvgPageset(const QDomElement &parent);
+        inline void parseSvgSectionAttr(const QXmlStreamAttributes &);
+        bool parseSvgPage(QXmlStreamReader &reader, bool atFirstElement = false);
+        bool parseSvgPageset(QXmlStreamReader &reader);
         bool parseSvgElement(const QDomElement &parent);
         bool parseIwbMeta(const QDomElement &element);
-        bool parseSvg(const QDomElement &svgSection);
+        bool parseSvg(QXmlStreamReader &reader);
 
         inline bool parseGSection(const QDomElement &element);
         inline bool parseSvgSwitchSection(const QDomElement &element);
@@ -117,7 +121,7 @@ private:
         inline bool parseSvgAudio(const QDomElement &element);
         inline bool parseSvgVideo(const QDomElement &element);
         inline UBGraphicsGroupContainerItem *parseIwbGroup(QDomElement &parent);
-        inline bool parseIwbElement(QDomElement &element);
+        inline bool parseIwbElement(const QDomElement &element, UBGraphicsItem *referedItem);
         inline void parseTSpan(const QDomElement &parent, QPainter &painter
                                , qreal &curX, qreal &curY, qreal &width, qreal &height, qreal &linespacing, QRectF &lastDrawnTextBoundingRect
                                , qreal &fontSize, QColor &fontColor, QString &fontFamily, QString &fontStretch, bool &italic
@@ -136,10 +140,11 @@ private:
 
         //elements parsing methods
         bool parseDoc();
+        QDomElement readDomElement(QXmlStreamReader &reader, QDomDocument &document);
+        void skipRemainingElements(QXmlStreamReader &reader);
 
         bool createNewScene();
         bool persistCurrentScene();
-        bool persistScenes();
 
 //        helper methods
         void repositionSvgItem(QGraphicsItem *item, qreal width, qreal height,
@@ -149,7 +154,7 @@ private:
         QTransform transformFromString(const QString trString, QGraphicsItem *item = 0);
         bool getViewBoxDimenstions(const QString& viewBox);
         QSvgGenerator* createSvgGenerator(qreal width, qreal height);
-        bool getTempFileName();
+        UBGraphicsSvgItem* addSvgShape(const QUuid &uuid);
         inline bool strToBool(QString);
         bool createTempFlashPath();
     };
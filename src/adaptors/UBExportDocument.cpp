@@ -33,6 +33,7 @@
 
 #include "core/UBDocumentManager.h"
 #include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
 
 #include "document/UBDocumentProxy.h"
 #include "document/UBDocumentController.h"
@@ -76,6 +77,8 @@ bool UBExportDocument::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocume
         return false;
     }
 
+    UBPersistenceManager::persistenceManager()->waitForAssetCopies();
+
     QDir documentDir = QDir(pDocumentProxy->persistencePath());
 
     QuaZipFile outFile(&zip);
@@ -174,6 +174,8 @@ bool UBExportDocumentSetAdaptor::addDocumentToZip(const QModelIndex &pIndex, UBD
         QString documentPath(pDocumentProxy->persistencePath());
         //document.checkDocumentDirectory(documentPath);
 
+        UBPersistenceManager::persistenceManager()->waitForAssetCopies();
+
         QDir documentDir = QDir(pDocumentProxy->persistencePath());
         QuaZipFile zipFile(&zip);
         UBFileSystemUtils::compressDirInZip(documentDir, QFileInfo(documentPath).fileName() + "/", &zipFile, false);
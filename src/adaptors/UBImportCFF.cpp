@@ -180,7 +180,6 @@ QString UBImportCFF::expandFileToDir(const QFile& pZipFile, const QString& pDir)
     }
 
     QFile out;
-    char c;
     for(bool more=zip.goToFirstFile(); more; more=zip.goToNextFile()) {
         if(!zip.getCurrentFileInfo(&info)) {
             //TOD UB 4.3 O display error to user or use crash reporter
@@ -205,8 +204,7 @@ QString UBImportCFF::expandFileToDir(const QFile& pZipFile, const QString& pDir)
         out.setFileName(newFileName);
         out.open(QIODevice::WriteOnly);
 
-        while(file.getChar(&c))
-            out.putChar(c);
+        UBFileSystemUtils::copyStream(file, out);
 
         out.close();
 
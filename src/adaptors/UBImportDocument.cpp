@@ -91,7 +91,6 @@ bool UBImportDocument::extractFileToDir(const QFile& pZipFile, const QString& pD
     QuaZipFile file(&zip);
 
     QFile out;
-    char c;
     documentRoot = UBPersistenceManager::persistenceManager()->generateUniqueDocumentPath(pDir);
     for(bool more=zip.goToFirstFile(); more; more=zip.goToNextFile())
     {
@@ -123,20 +122,13 @@ bool UBImportDocument::extractFileToDir(const QFile& pZipFile, const QString& pD
         if (!out.open(QIODevice::WriteOnly))
             return false;
 
-        // Slow like hell (on GNU/Linux at least), but it is not my fault.
-        // Not ZIP/UNZIP package's fault either.
-        // The slowest thing here is out.putChar(c).
-        QByteArray outFileContent = file.readAll();
-        if (out.write(outFileContent) == -1)
+        if (!UBFileSystemUtils::copyStream(file, out))
         {
             qWarning() << "Import failed. Cause: Unable to write file";
             out.close();
             return false;
         }
 
-        while(file.getChar(&c))
-            out.putChar(c);
-
         out.close();
 
         if(file.getZipError()!=UNZ_OK)
@@ -131,7 +131,6 @@ bool UBImportDocumentSetAdaptor::extractFileToDir(const QFile& pZipFile, const Q
     QuaZipFile file(&zip);
 
     QFile out;
-    char c;
 
     QString documentRoot = QFileInfo(pDir).absoluteFilePath();
     for(bool more=zip.goToFirstFile(); more; more=zip.goToNextFile())
@@ -169,20 +168,13 @@ bool UBImportDocumentSetAdaptor::extractFileToDir(const QFile& pZipFile, const Q
         if (!out.open(QIODevice::WriteOnly))
             return false;
 
-        // Slow like hell (on GNU/Linux at least), but it is not my fault.
-        // Not ZIP/UNZIP package's fault either.
-        // The slowest thing here is out.putChar(c).
-        QByteArray outFileContent = file.readAll();
-        if (out.write(outFileContent) == -1)
+        if (!UBFileSystemUtils::copyStream(file, out))
         {
             qWarning() << "Import failed. Cause: Unable to write file";
             out.close();
             return false;
         }
 
-        while(file.getChar(&c))
-            out.putChar(c);
-
         out.close();
 
         if(file.getZipError()!=UNZ_OK)
@@ -37,6 +37,10 @@
 #include <QGraphicsVideoItem>
 #include <QElapsedTimer>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include "domain/UBGraphicsSvgItem.h"
 #include "domain/UBGraphicsPixmapItem.h"
 #include "domain/UBGraphicsPolygonItem.h"
@@ -76,6 +80,7 @@
 #include "core/UBApplication.h"
 #include "core/UBDisplayManager.h"
 #include "core/UBTextTools.h"
+#include "core/UBTrace.h"
 
 #include "pdf/PDFRenderer.h"
 
@@ -244,53 +249,23 @@ QString UBSvgSubsetAdaptor::uniboardDocumentNamespaceUriFromVersion(int mFileVer
 
 std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
+    UB_TRACE_SCOPE("persistence", "loadScene");
+
     UBApplication::showMessage(QObject::tr("Loading scene (%1/%2)").arg(pageIndex+1).arg(proxy->pageCount()));
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
     qInfo() << "loading scene. Filename is : " << fileName;
-    QFile file(fileName);
 
-    if (file.exists())
+    if (QFile::exists(fileName))
     {
-        if (!file.open(QIODevice::ReadOnly))
-        {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
-            return 0;
-        }
-
-        std::shared_ptr<UBGraphicsScene> scene = loadScene(proxy, file.readAll());
-
-        file.close();
-
-        return scene;
+        // the page is parsed completely before returning, it can stay mapped meanwhile
+        UBSvgSubsetReader reader(proxy, fileName, true);
+        return reader.loadScene(proxy);
     }
 
     return 0;
 }
 
 
-QByteArray UBSvgSubsetAdaptor::loadSceneAsText(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
-{
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
-    qDebug() << fileName;
-    QFile file(fileName);
-
-    if (file.exists())
-    {
-        if (!file.open(QIODevice::ReadOnly))
-        {
-            qWarning() << "Cannot open file " << fileName << " for reading ...";
-            return "";
-        }
-
-        return file.readAll();
-
-        file.close();
-
-    }
-    return "";
-}
-
-
 QUuid UBSvgSubsetAdaptor::sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
@@ -340,19 +315,88 @@ QUuid UBSvgSubsetAdaptor::sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, cons
 
 std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pArray)
 {
-    UBSvgSubsetReader reader(proxy, UBTextTools::cleanHtmlCData(QString(pArray)).toUtf8());
+    QByteArray data(pArray);
+    removeNulBytes(data);
+
+    UBSvgSubsetReader reader(proxy, data);
     return reader.loadScene(proxy);
 }
 
 std::shared_ptr<UBSvgSubsetAdaptor::UBSvgReaderContext> UBSvgSubsetAdaptor::prepareLoadingScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
-    const auto fileContent = loadSceneAsText(proxy, pageIndex);
-    auto context = std::make_shared<UBSvgReaderContext>(proxy, fileContent);
+    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    auto context = std::make_shared<UBSvgReaderContext>(proxy, fileName);
     return context;
 }
 
+
+/**
+ * Read the content of a page file. If mapFile is set, the file is kept open and mapped
+ * as long as it exists, so it must only be used when the page is parsed at once: incremental
+ * loads would prevent renaming or rewriting the page file in between.
+ */
+QByteArray UBSvgSubsetAdaptor::readSceneData(QFile& file, bool mapFile)
+{
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (file.exists())
+            qWarning() << "Cannot open file " << file.fileName() << " for reading ...";
+
+        return QByteArray();
+    }
+
+    const qint64 size = file.size();
+    uchar* mapped = mapFile && size > 0 && size < std::numeric_limits<int>::max() ? file.map(0, size) : nullptr;
+
+    if (!mapped)
+    {
+        QByteArray data = file.readAll();
+        file.close();
+        removeNulBytes(data);
+        return data;
+    }
+
+    const char* data = reinterpret_cast<const char*>(mapped);
+
+    // pages written by older versions may contain NUL characters in text items, which the
+    // XML reader rejects. Only those pay for a copy, clean pages are parsed from the mapping.
+    if (!memchr(data, '\0', size))
+        return QByteArray::fromRawData(data, int(size));
+
+    QByteArray cleaned(data, int(size));
+    file.unmap(mapped);
+    file.close();
+    removeNulBytes(cleaned);
+    return cleaned;
+}
+
+
+void UBSvgSubsetAdaptor::removeNulBytes(QByteArray& data)
+{
+    if (!data.contains('\0'))
+        return;
+
+    char* begin = data.data();
+    char* end = std::remove(begin, begin + data.size(), '\0');
+    data.truncate(int(end - begin));
+}
+
+
 UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> pProxy, const QByteArray& pXmlData)
-    : mXmlReader(pXmlData)
+    : mXmlData(pXmlData)
+    , mXmlReader(mXmlData)
+    , mProxy(pProxy)
+    , mDocumentPath(pProxy->persistencePath())
+    , mGroupHasInfo(false)
+{
+    // NOOP
+}
+
+
+UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> pProxy, const QString& pFileName, bool mapFile)
+    : mFile(pFileName)
+    , mXmlData(readSceneData(mFile, mapFile))
+    , mXmlReader(mXmlData)
     , mProxy(pProxy)
     , mDocumentPath(pProxy->persistencePath())
     , mGroupHasInfo(false)
@@ -749,9 +793,6 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
                 mScene->addItem(audioItem);
 
                 audioItem->show();
-
-                audioItem->play();
-                audioItem->pause();
             }
         }
         else if (name == "video")
@@ -1179,6 +1220,8 @@ QGraphicsItem *UBSvgSubsetAdaptor::UBSvgSubsetReader::readElementFromGroup()
 
 void UBSvgSubsetAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, const int pageIndex)
 {
+    UB_TRACE_SCOPE("persistence", "persistScene");
+
     UBSvgSubsetWriter writer(proxy, pScene, pageIndex);
     writer.persistScene(proxy, pageIndex);
 }
@@ -3505,9 +3548,9 @@ void UBSvgSubsetAdaptor::convertSvgImagesToImages(std::shared_ptr<UBDocumentProx
     }
 }
 
-UBSvgSubsetAdaptor::UBSvgReaderContext::UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData)
+UBSvgSubsetAdaptor::UBSvgReaderContext::UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QString& pFileName)
 {
-    reader = new UBSvgSubsetReader(proxy, pXmlData);
+    reader = new UBSvgSubsetReader(proxy, pFileName);
     reader->start();
 }
 
@@ -73,7 +73,7 @@ class UBSvgSubsetAdaptor
         class UBSvgReaderContext
         {
         public:
-            UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData);
+            UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QString& pFileName);
             ~UBSvgReaderContext();
             bool isFinished() const;
             void step();
@@ -84,7 +84,6 @@ class UBSvgSubsetAdaptor
         };
 
         static std::shared_ptr<UBGraphicsScene> loadScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
-        static QByteArray loadSceneAsText(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
         static std::shared_ptr<UBGraphicsScene> loadScene(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pArray);
         static std::shared_ptr<UBSvgReaderContext> prepareLoadingScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
 
@@ -94,6 +93,9 @@ class UBSvgSubsetAdaptor
         static QUuid sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
         static void setSceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex, QUuid pUuid);
 
+        // content of a page file, without the NUL characters of pages written by older versions
+        static QByteArray readSceneData(QFile& file, bool mapFile);
+
         static void convertPDFObjectsToImages(std::shared_ptr<UBDocumentProxy> proxy);
         static void convertSvgImagesToImages(std::shared_ptr<UBDocumentProxy> proxy);
 
@@ -120,12 +122,14 @@ class UBSvgSubsetAdaptor
         static QString toSvgTransform(const QTransform& matrix);
         static QTransform fromSvgTransform(const QString& transform);
 
+        static void removeNulBytes(QByteArray& data);
 
         class UBSvgSubsetReader
         {
             public:
 
                 UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData);
+                UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> proxy, const QString& pFileName, bool mapFile = false);
 
                 virtual ~UBSvgSubsetReader(){}
 
@@ -182,6 +186,9 @@ class UBSvgSubsetAdaptor
 
                 qreal normalizedZValue(bool* hasValue);
 
+                // declared before the reader, which parses the (possibly mapped) data they hold
+                QFile mFile;
+                QByteArray mXmlData;
                 QXmlStreamReader mXmlReader;
                 int mFileVersion;
                 std::shared_ptr<UBDocumentProxy> mProxy;
@@ -36,6 +36,7 @@
 #include "core/UBPersistenceManager.h"
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
+#include "core/UBTrace.h"
 
 #include "board/UBBoardController.h"
 #include "board/UBBoardPaletteManager.h"
@@ -113,6 +114,8 @@ void UBThumbnailAdaptor::load(std::shared_ptr<UBDocumentProxy> proxy, QList<std:
 
 void UBThumbnailAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, int pageIndex, bool overrideModified)
 {
+    UB_TRACE_SCOPE("thumbnail", "persistScene");
+
     QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
 
     QFile thumbFile(fileName);
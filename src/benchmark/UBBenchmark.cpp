@@ -0,0 +1,817 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include "UBBenchmark.h"
+
+#include <QtGui>
+#include <QPdfWriter>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <cmath>
+#include <limits>
+
+#include "core/UBApplication.h"
+#include "core/UBSettings.h"
+#include "core/UBSetting.h"
+#include "core/UBPersistenceManager.h"
+#include "core/UBSceneCache.h"
+#include "core/UBDownloadManager.h"
+
+#include "adaptors/UBSvgSubsetAdaptor.h"
+#include "adaptors/UBThumbnailAdaptor.h"
+#include "adaptors/UBExportPDF.h"
+#include "adaptors/UBMetadataDcSubsetAdaptor.h"
+
+#include "board/UBBoardController.h"
+#include "board/UBBoardView.h"
+#include "board/UBDrawingController.h"
+
+#include "document/UBDocumentProxy.h"
+
+#include "domain/UBGraphicsScene.h"
+#include "domain/UBGraphicsItemUndoCommand.h"
+#include "domain/UBGraphicsPolygonItem.h"
+#include "domain/UBGraphicsStrokesGroup.h"
+
+#include "network/UBHttpGet.h"
+
+#include <Merger.h>
+#include <Transformation.h>
+
+#include "core/memcheck.h"
+
+using namespace merge_lib;
+
+// size of the synthetic documents
+static const int sInkPageCount = 50;
+static const int sStrokesPerPage = 100;
+static const int sImagePageCount = 20;
+static const int sImagesPerPage = 8;
+static const int sWidgetPageCount = 5;
+static const int sWidgetsPerPage = 10;
+static const int sMergedPdfPageCount = 1000;
+static const int sUndoStrokeCount = 500; // about 100 polygons per stroke
+static const int sDownloadSize = 16 * 1024 * 1024;
+static const int sDownloadTimeout = 30000; // ms
+
+static const int sIterations = 3;
+static const int sSettingReads = 1000000;
+
+
+UBBenchmark::UBBenchmark(const QString& resultPath)
+    : mResultPath(resultPath)
+    , mChecksPassed(true)
+{
+    // NOOP
+}
+
+
+UBBenchmark::~UBBenchmark()
+{
+    // NOOP
+}
+
+
+QString UBBenchmark::resultPathFromArguments(const QStringList& arguments)
+{
+    const QString prefix("--benchmark=");
+
+    foreach (const QString& argument, arguments)
+    {
+        if (argument.startsWith(prefix))
+        {
+            return argument.mid(prefix.length());
+        }
+    }
+
+    return QString();
+}
+
+
+bool UBBenchmark::run()
+{
+    if (!mWorkDir.isValid())
+    {
+        qWarning() << "cannot create benchmark directory" << mWorkDir.path();
+        return false;
+    }
+
+    qDebug() << "running benchmarks in" << mWorkDir.path();
+
+    int previousTool = UBDrawingController::drawingController()->stylusTool();
+
+    benchmarkSettings();
+
+    QList<QPair<QString, std::shared_ptr<UBDocumentProxy>>> documents;
+
+    documents << qMakePair(QString("ink"), createDocument("ink", sInkPageCount, [](std::shared_ptr<UBGraphicsScene> scene, int pageIndex) {
+        addStrokes(scene, sStrokesPerPage, pageIndex);
+    }));
+
+    documents << qMakePair(QString("images"), createDocument("images", sImagePageCount, [](std::shared_ptr<UBGraphicsScene> scene, int pageIndex) {
+        addImages(scene, sImagesPerPage, pageIndex);
+    }));
+
+    documents << qMakePair(QString("widgets"), createDocument("widgets", sWidgetPageCount, [](std::shared_ptr<UBGraphicsScene> scene, int) {
+        addWidgets(scene, sWidgetsPerPage);
+    }));
+
+    for (int i = 0; i < documents.size(); ++i)
+    {
+        const QString& name = documents.at(i).first;
+        std::shared_ptr<UBDocumentProxy> document = documents.at(i).second;
+
+        if (!document)
+        {
+            qWarning() << "cannot create benchmark document" << name;
+            continue;
+        }
+
+        benchmarkSvg(document, name);
+        benchmarkSceneCache(document, name);
+        benchmarkThumbnails(document, name);
+        benchmarkPdfExport(document, name);
+
+        UBPersistenceManager::persistenceManager()->deleteDocument(document);
+    }
+
+    benchmarkPdfMerger();
+    benchmarkGestures();
+    benchmarkUndo();
+    benchmarkDownloads();
+
+    UBDrawingController::drawingController()->setStylusTool(previousTool);
+
+    QJsonObject root;
+    root["version"] = QString(UBVERSION);
+    root["qt"] = QString(qVersion());
+    root["platform"] = QGuiApplication::platformName();
+    root["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["results"] = mResults;
+
+    QFile resultFile(mResultPath);
+
+    if (!resultFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "cannot write benchmark results to" << mResultPath;
+        return false;
+    }
+
+    resultFile.write(QJsonDocument(root).toJson());
+    resultFile.close();
+
+    qDebug() << "benchmark results written to" << mResultPath;
+
+    return mChecksPassed;
+}
+
+
+void UBBenchmark::measure(const QString& name, int iterations, std::function<void()> operation, std::function<void()> prepare)
+{
+    QElapsedTimer timer;
+    qint64 total = 0;
+    qint64 minimum = std::numeric_limits<qint64>::max();
+    qint64 maximum = 0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        // not timed, e.g. to give each iteration the same starting point
+        if (prepare)
+            prepare();
+
+        timer.start();
+        operation();
+        qint64 elapsed = timer.nsecsElapsed();
+
+        total += elapsed;
+        minimum = qMin(minimum, elapsed);
+        maximum = qMax(maximum, elapsed);
+    }
+
+    QJsonObject result;
+    result["name"] = name;
+    result["iterations"] = iterations;
+    result["mean_ms"] = total / 1e6 / iterations;
+    result["min_ms"] = minimum / 1e6;
+    result["max_ms"] = maximum / 1e6;
+
+    mResults.append(result);
+
+    qDebug() << "benchmark" << name << ":" << total / 1e6 / iterations << "ms";
+}
+
+
+void UBBenchmark::setResultValue(const QString& key, const QJsonValue& value)
+{
+    // adds a value to the result of the last measure
+    if (mResults.isEmpty())
+        return;
+
+    QJsonObject result = mResults.last().toObject();
+    result[key] = value;
+    mResults.replace(mResults.size() - 1, result);
+}
+
+
+void UBBenchmark::check(const QString& name, bool passed)
+{
+    // the outcome is added to the result of the last measure
+    setResultValue(name, passed);
+
+    if (!passed)
+    {
+        qWarning() << "benchmark check failed:" << name;
+        mChecksPassed = false;
+    }
+}
+
+
+std::shared_ptr<UBDocumentProxy> UBBenchmark::createDocument(const QString& name, int pageCount, PageFiller filler)
+{
+    QString path = mWorkDir.filePath(name);
+    QDir().mkpath(path);
+
+    std::shared_ptr<UBDocumentProxy> proxy = std::make_shared<UBDocumentProxy>(path);
+    proxy->setMetaData(UBSettings::documentName, QString("Benchmark %1").arg(name));
+    UBMetadataDcSubsetAdaptor::persist(proxy);
+
+    for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex)
+    {
+        std::shared_ptr<UBGraphicsScene> scene = std::make_shared<UBGraphicsScene>(proxy, false);
+        filler(scene, pageIndex);
+        UBSvgSubsetAdaptor::persistScene(proxy, scene, pageIndex);
+    }
+
+    // read the document back, so that it is set up like the documents of the user
+    QFileInfo documentInfo(path);
+    return UBPersistenceManager::persistenceManager()->createDocumentProxyStructure(documentInfo);
+}
+
+
+void UBBenchmark::addStrokes(std::shared_ptr<UBGraphicsScene> scene, int strokeCount, int seed)
+{
+    QRandomGenerator random(seed);
+    QRectF area = scene->normalizedSceneRect();
+
+    for (int i = 0; i < strokeCount; ++i)
+    {
+        QPointF start(area.left() + random.bounded(qMax(1, int(area.width()) - 400)),
+                      area.top() + 40 + random.bounded(qMax(1, int(area.height()) - 80)));
+
+        drawGesture(scene, UBStylusTool::Pen, start, 100);
+    }
+}
+
+
+void UBBenchmark::addImages(std::shared_ptr<UBGraphicsScene> scene, int imageCount, int seed)
+{
+    QRandomGenerator random(seed);
+    QRectF area = scene->normalizedSceneRect();
+
+    for (int i = 0; i < imageCount; ++i)
+    {
+        QImage image(1024, 768, QImage::Format_RGB32);
+
+        QLinearGradient gradient(0, 0, image.width(), image.height());
+        gradient.setColorAt(0, QColor::fromRgb(random.generate()));
+        gradient.setColorAt(1, QColor::fromRgb(random.generate()));
+
+        QPainter painter(&image);
+        painter.fillRect(image.rect(), gradient);
+
+        for (int j = 0; j < 50; ++j)
+        {
+            painter.fillRect(random.bounded(image.width()), random.bounded(image.height()), 80, 60, QColor::fromRgb(random.generate()));
+        }
+
+        painter.end();
+
+        QPointF pos(area.left() + random.bounded(qMax(1, int(area.width()))),
+                    area.top() + random.bounded(qMax(1, int(area.height()))));
+
+        scene->addPixmap(QPixmap::fromImage(image), nullptr, pos, 0.3);
+    }
+}
+
+
+void UBBenchmark::addWidgets(std::shared_ptr<UBGraphicsScene> scene, int widgetCount)
+{
+    QString widgetPath = UBSettings::settings()->applicationApplicationsLibraryDirectory() + "/Calculator.wgt";
+
+    if (!QFileInfo::exists(widgetPath))
+    {
+        qWarning() << "benchmark widget not found" << widgetPath;
+        return;
+    }
+
+    for (int i = 0; i < widgetCount; ++i)
+    {
+        scene->addW3CWidget(QUrl::fromLocalFile(widgetPath), QPointF(i * 60, i * 40));
+    }
+}
+
+
+void UBBenchmark::drawGesture(std::shared_ptr<UBGraphicsScene> scene, int tool, const QPointF& start, int pointCount)
+{
+    UBDrawingController::drawingController()->setStylusTool(tool);
+
+    scene->inputDevicePress(start, 0.5);
+
+    for (int i = 1; i < pointCount; ++i)
+    {
+        QPointF point = start + QPointF(i * 4, 40 * std::sin(i / 8.));
+        scene->inputDeviceMove(point, 0.5 + 0.4 * std::sin(i / 16.));
+    }
+
+    scene->inputDeviceRelease(tool);
+}
+
+
+QString UBBenchmark::createPdf(const QString& name, int pageCount, const QString& text)
+{
+    QString path = mWorkDir.filePath(name + ".pdf");
+
+    QPdfWriter pdfWriter(path);
+    pdfWriter.setPdfVersion(QPagedPaintDevice::PdfVersion_1_4);
+    pdfWriter.setPageSize(QPageSize(QPageSize::A4));
+
+    QPainter painter(&pdfWriter);
+
+    for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex)
+    {
+        if (pageIndex > 0)
+            pdfWriter.newPage();
+
+        painter.drawText(QPointF(200, 200), text.arg(pageIndex + 1));
+        painter.drawRect(QRectF(200, 400, 2000, 1000));
+    }
+
+    painter.end();
+
+    return path;
+}
+
+
+void UBBenchmark::benchmarkSettings()
+{
+    // the baseline is the read done before the typed accessors: a lookup in the
+    // settings followed by the conversion of the variant, on every call
+    UBSettings* settings = UBSettings::settings();
+    UBSetting* boolSetting = settings->boardPenPressureSensitive;
+    UBSetting* colorSetting = settings->boardCrossColorLightBackground;
+    volatile bool value = false;
+    volatile QRgb color = 0;
+
+    measure("settings/value/bool", 1, [&]() {
+        for (int i = 0; i < sSettingReads; ++i)
+            value = settings->value(boolSetting->path(), boolSetting->defaultValue()).toBool();
+    });
+
+    measure("settings/getBool", 1, [&]() {
+        for (int i = 0; i < sSettingReads; ++i)
+            value = boolSetting->getBool();
+    });
+
+    measure("settings/value/color", 1, [&]() {
+        for (int i = 0; i < sSettingReads; ++i)
+        {
+            QString name = settings->value(colorSetting->path(), colorSetting->defaultValue()).toString();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 4, 0))
+            color = QColor::fromString(name).rgba();
+#else
+            color = QColor(name).rgba();
+#endif
+        }
+    });
+
+    measure("settings/getColor", 1, [&]() {
+        for (int i = 0; i < sSettingReads; ++i)
+            color = colorSetting->getColor().rgba();
+    });
+
+    Q_UNUSED(value);
+    Q_UNUSED(color);
+}
+
+
+void UBBenchmark::benchmarkSvg(std::shared_ptr<UBDocumentProxy> document, const QString& name)
+{
+    QList<std::shared_ptr<UBGraphicsScene>> scenes;
+
+    measure(QString("svg/load/%1").arg(name), sIterations, [&]() {
+        scenes.clear();
+
+        for (int pageIndex = 0; pageIndex < document->pageCount(); ++pageIndex)
+            scenes << UBSvgSubsetAdaptor::loadScene(document, pageIndex);
+    });
+
+    measure(QString("svg/save/%1").arg(name), sIterations, [&]() {
+        for (int pageIndex = 0; pageIndex < scenes.size(); ++pageIndex)
+        {
+            if (scenes.at(pageIndex))
+                UBSvgSubsetAdaptor::persistScene(document, scenes.at(pageIndex), pageIndex);
+        }
+    });
+}
+
+
+void UBBenchmark::benchmarkSceneCache(std::shared_ptr<UBDocumentProxy> document, const QString& name)
+{
+    measure(QString("scenecache/churn/%1").arg(name), sIterations, [&]() {
+        UBSceneCache cache;
+
+        for (int pageIndex = 0; pageIndex < document->pageCount(); ++pageIndex)
+            cache.prepareLoading(document, pageIndex);
+
+        for (int pageIndex = 0; pageIndex < document->pageCount(); ++pageIndex)
+            cache.value(document, pageIndex);
+
+        // revisit the pages backwards, as when browsing back in the document
+        for (int pageIndex = document->pageCount() - 1; pageIndex >= 0; --pageIndex)
+        {
+            if (!cache.contains(document, pageIndex))
+                cache.prepareLoading(document, pageIndex);
+
+            cache.value(document, pageIndex);
+        }
+
+        cache.removeAllScenes(document);
+    });
+}
+
+
+void UBBenchmark::benchmarkThumbnails(std::shared_ptr<UBDocumentProxy> document, const QString& name)
+{
+    QList<std::shared_ptr<UBGraphicsScene>> scenes;
+
+    for (int pageIndex = 0; pageIndex < document->pageCount(); ++pageIndex)
+        scenes << UBSvgSubsetAdaptor::loadScene(document, pageIndex);
+
+    measure(QString("thumbnail/persist/%1").arg(name), sIterations, [&]() {
+        for (int pageIndex = 0; pageIndex < scenes.size(); ++pageIndex)
+        {
+            if (scenes.at(pageIndex))
+                UBThumbnailAdaptor::persistScene(document, scenes.at(pageIndex), pageIndex, true);
+        }
+    });
+
+    measure(QString("thumbnail/load/%1").arg(name), sIterations, [&]() {
+        QList<std::shared_ptr<QPixmap>> thumbnails;
+        UBThumbnailAdaptor::load(document, thumbnails);
+    });
+}
+
+
+void UBBenchmark::benchmarkPdfExport(std::shared_ptr<UBDocumentProxy> document, const QString& name)
+{
+    UBExportPDF exporter;
+    QString path = mWorkDir.filePath(name + "-export.pdf");
+
+    measure(QString("pdf/export/%1").arg(name), 1, [&]() {
+        exporter.persistsDocument(document, path);
+    });
+}
+
+
+void UBBenchmark::benchmarkPdfMerger()
+{
+    QString basePath = createPdf("base", sMergedPdfPageCount, "Base page %1");
+    QString overlayPath = createPdf("overlay", sMergedPdfPageCount, "Overlay page %1");
+    QString mergedPath = mWorkDir.filePath("merged.pdf");
+
+    QByteArray baseName = QFile::encodeName(basePath);
+    QByteArray overlayName = QFile::encodeName(overlayPath);
+    QSizeF pageSize = QPageSize(QPageSize::A4).size(QPageSize::Point);
+
+    measure(QString("pdf/merge/%1").arg(sMergedPdfPageCount), 1, [&]() {
+        try
+        {
+            Merger merger;
+            merger.addOverlayDocument(overlayName.constData());
+            merger.addBaseDocument(baseName.constData());
+
+            MergeDescription mergeInfo;
+
+            for (int pageIndex = 0; pageIndex < sMergedPdfPageCount; ++pageIndex)
+            {
+                mergeInfo.push_back(MergePageDescription(pageSize.width(), pageSize.height(),
+                                                         pageIndex + 1, baseName.constData(), TransformationDescription(),
+                                                         pageIndex + 1, TransformationDescription()));
+            }
+
+            merger.merge(overlayName.constData(), mergeInfo);
+            merger.saveMergedDocumentsAs(QFile::encodeName(mergedPath).constData());
+        }
+        catch (const std::exception& e)
+        {
+            qWarning() << "pdf merger benchmark failed:" << e.what();
+        }
+    });
+}
+
+
+void UBBenchmark::benchmarkGestures()
+{
+    std::shared_ptr<UBDocumentProxy> proxy = std::make_shared<UBDocumentProxy>();
+    std::shared_ptr<UBGraphicsScene> scene;
+    qint64 repaintedArea = 0;
+
+    // the gestures are replayed on a scene shown in a board view, to measure the area it repaints
+    UBBoardView view(UBApplication::boardController, nullptr, false, false);
+    view.resize(1280, 800);
+    view.show();
+
+    auto flushRepaints = []() {
+        // scene changes reach the view through queued calls, the view then posts its update request
+        QCoreApplication::processEvents();
+        QCoreApplication::processEvents();
+    };
+
+    auto prepareScene = [&](int strokeCount) {
+        view.setScene(nullptr);
+        scene = std::make_shared<UBGraphicsScene>(proxy, false);
+        addStrokes(scene, strokeCount, 0);
+        view.setScene(scene.get());
+        flushRepaints();
+        view.resetRepaintedArea();
+    };
+
+    measure("gesture/pen", sIterations, [&]() {
+        addStrokes(scene, sStrokesPerPage, 0);
+        flushRepaints();
+        repaintedArea += view.repaintedArea();
+    }, [&]() {
+        prepareScene(0);
+    });
+
+    setResultValue("repainted_px", repaintedArea / sIterations);
+    repaintedArea = 0;
+
+    // each iteration erases the same strokes, not the leftovers of the previous one
+    measure("gesture/eraser", sIterations, [&]() {
+        QRectF area = scene->normalizedSceneRect();
+
+        for (qreal y = area.top(); y < area.bottom(); y += 80)
+            drawGesture(scene, UBStylusTool::Eraser, QPointF(area.left(), y), 100);
+
+        flushRepaints();
+        repaintedArea += view.repaintedArea();
+    }, [&]() {
+        prepareScene(sStrokesPerPage);
+    });
+
+    setResultValue("repainted_px", repaintedArea / sIterations);
+
+    view.setScene(nullptr);
+}
+
+
+void UBBenchmark::benchmarkUndo()
+{
+    std::shared_ptr<UBDocumentProxy> proxy = std::make_shared<UBDocumentProxy>();
+    std::shared_ptr<UBGraphicsScene> scene = std::make_shared<UBGraphicsScene>(proxy, false);
+    addStrokes(scene, sUndoStrokeCount, 0);
+
+    // erase every polygon of the page, the way the eraser does
+    QSet<QGraphicsItem*> removedItems;
+
+    foreach (QGraphicsItem* item, scene->items())
+    {
+        UBGraphicsPolygonItem* polygon = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+
+        if (polygon && polygon->strokesGroup())
+            removedItems << polygon;
+    }
+
+    scene->beginBulkChange();
+
+    foreach (QGraphicsItem* item, removedItems)
+    {
+        UBGraphicsPolygonItem* polygon = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+        polygon->strokesGroup()->removeFromGroup(polygon);
+        scene->removeItem(polygon);
+    }
+
+    scene->endBulkChange();
+
+    QUndoCommand* command = new UBGraphicsItemUndoCommand(scene, removedItems, QSet<QGraphicsItem*>());
+
+    // the undo stack calls redo when the command is pushed
+    command->redo();
+
+    measure(QString("undo/erase_%1_items").arg(removedItems.size()), sIterations, [&]() {
+        command->undo();
+        command->redo();
+    });
+
+    // put the polygons back into their strokes, so that they are deleted with the scene
+    command->undo();
+    delete command;
+}
+
+
+void UBBenchmark::benchmarkDownloads()
+{
+    std::shared_ptr<UBDocumentProxy> document = createDocument("downloads", 1, [](std::shared_ptr<UBGraphicsScene>, int) {});
+
+    if (!document)
+    {
+        qWarning() << "cannot create benchmark document downloads";
+        mChecksPassed = false;
+        return;
+    }
+
+    QByteArray content(sDownloadSize, Qt::Uninitialized);
+    QRandomGenerator(0).fillRange(reinterpret_cast<quint32*>(content.data()), content.size() / sizeof(quint32));
+
+    QString sourcePath = mWorkDir.filePath("download.mp4");
+    QFile source(sourcePath);
+
+    if (!source.open(QIODevice::WriteOnly) || source.write(content) != content.size())
+    {
+        qWarning() << "cannot write benchmark download" << sourcePath;
+        mChecksPassed = false;
+        UBPersistenceManager::persistenceManager()->deleteDocument(document);
+        return;
+    }
+
+    source.close();
+
+    auto waitFor = [](std::function<bool()> done) {
+        QElapsedTimer timer;
+        timer.start();
+
+        while (!done() && timer.elapsed() < sDownloadTimeout)
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+
+        return done();
+    };
+
+    // local files are copied into the document shown on the board
+    UBBoardController* boardController = UBApplication::boardController;
+    std::shared_ptr<UBDocumentProxy> previousDocument = boardController->selectedDocument();
+    int previousSceneIndex = boardController->activeSceneIndex();
+    boardController->setActiveDocumentScene(document, 0);
+
+    QDir videoDir(document->persistencePath() + "/" + UBPersistenceManager::videoDirectory);
+    auto removeVideos = [&]() {
+        foreach (const QString& file, videoDir.entryList(QDir::Files))
+            videoDir.remove(file);
+    };
+
+    sDownloadFileDesc desc;
+    desc.srcUrl = QUrl::fromLocalFile(sourcePath).toString();
+
+    bool copied = false;
+    QString copyPath;
+
+    measure("download/file", sIterations, [&]() {
+        bool finished = false;
+        UBAsyncLocalFileDownloader downloader(desc);
+
+        QObject::connect(&downloader, &UBAsyncLocalFileDownloader::signal_asyncCopyFinished, &downloader,
+                         [&](int, bool pSuccess, QUrl sourceUrl, QUrl, QString, QByteArray, QPointF, QSize, bool) {
+            finished = true;
+            copied = pSuccess;
+            copyPath = sourceUrl.toLocalFile();
+        });
+
+        downloader.download();
+        waitFor([&]() { return finished; });
+        downloader.wait();
+    }, [&]() {
+        removeVideos();
+        copied = false;
+    });
+
+    check("copied", copied && QFileInfo(copyPath).size() == content.size());
+
+    // the copy must not share its data with the file of the user
+    QFile copy(copyPath);
+    bool written = copy.open(QIODevice::Append) && copy.write("x") == 1;
+    copy.close();
+    check("copy_independent", written && QFileInfo(sourcePath).size() == content.size());
+
+    removeVideos();
+
+    {
+        UBAsyncLocalFileDownloader downloader(desc);
+        downloader.abort();
+        downloader.download();
+        downloader.wait();
+    }
+
+    check("cancelled_copy_removed", videoDir.entryList(QDir::Files).isEmpty());
+
+    if (previousDocument)
+        boardController->setActiveDocumentScene(previousDocument, previousSceneIndex);
+
+    // remote files are downloaded from a local server into a staged file of the document
+    enum ServerMode { CompleteResponse, TruncatedResponse, StalledResponse };
+    ServerMode mode = CompleteResponse;
+
+    QTcpServer server;
+
+    if (!server.listen(QHostAddress::LocalHost))
+    {
+        qWarning() << "cannot start benchmark download server" << server.errorString();
+        mChecksPassed = false;
+        UBPersistenceManager::persistenceManager()->deleteDocument(document);
+        return;
+    }
+
+    QObject::connect(&server, &QTcpServer::newConnection, &server, [&]() {
+        while (QTcpSocket* socket = server.nextPendingConnection())
+        {
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, &content, &mode]() {
+                // the request is small enough to arrive at once
+                socket->readAll();
+                socket->write("HTTP/1.1 200 OK\r\nContent-Type: video/mp4\r\nContent-Length: " + QByteArray::number(content.size())
+                              + "\r\nConnection: close\r\n\r\n");
+                socket->write(mode == CompleteResponse ? content : content.left(content.size() / 2));
+
+                if (mode != StalledResponse)
+                    socket->disconnectFromHost();
+            });
+        }
+    });
+
+    QUrl url(QString("http://127.0.0.1:%1/download.mp4").arg(server.serverPort()));
+    QString stagedPath = document->persistencePath() + "/.download-" + QUuid::createUuid().toString() + ".mp4";
+
+    auto download = [&](bool cancel) {
+        bool finished = false;
+        bool succeeded = false;
+
+        UBHttpGet http;
+        http.setDownloadFilePath(stagedPath);
+
+        QObject::connect(&http, &UBHttpGet::downloadFinished, &http, [&](bool pSuccess, QUrl, QString, QByteArray, QPointF, QSize, bool) {
+            finished = true;
+            succeeded = pSuccess;
+        });
+
+        QNetworkReply* reply = http.get(url);
+
+        if (cancel)
+        {
+            QObject::connect(&http, &UBHttpGet::downloadProgress, reply, [reply](qint64 bytesReceived, qint64) {
+                if (bytesReceived > 0)
+                    reply->abort();
+            });
+        }
+
+        return waitFor([&]() { return finished; }) && succeeded;
+    };
+
+    bool downloaded = false;
+
+    measure("download/http", sIterations, [&]() {
+        downloaded = download(false);
+    }, [&]() {
+        QFile::remove(stagedPath);
+    });
+
+    check("downloaded", downloaded && QFileInfo(stagedPath).size() == content.size());
+
+    QString destinationPath;
+    bool moved = UBPersistenceManager::persistenceManager()->moveFileToDocument(document, stagedPath, UBPersistenceManager::videoDirectory,
+                                                                                 QUuid::createUuid(), destinationPath);
+    check("staged_file_moved", moved && !QFile::exists(stagedPath) && QFileInfo(destinationPath).size() == content.size());
+
+    mode = TruncatedResponse;
+    check("failed_download_removed", !download(false) && !QFile::exists(stagedPath));
+
+    mode = StalledResponse;
+    check("cancelled_download_removed", !download(true) && !QFile::exists(stagedPath));
+
+    UBPersistenceManager::persistenceManager()->deleteDocument(document);
+}
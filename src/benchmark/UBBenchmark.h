@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef UBBENCHMARK_H_
+#define UBBENCHMARK_H_
+
+#include <QtCore>
+
+#include <functional>
+#include <memory>
+
+class UBDocumentProxy;
+class UBGraphicsScene;
+
+/**
+ * Performance benchmark suite, only built with the OPENBOARD_BENCHMARKS option.
+ *
+ * The suite is started with the --benchmark=<result file> command line argument once the
+ * application is initialized, e.g. with QT_QPA_PLATFORM=offscreen. It generates synthetic
+ * documents in a temporary directory, times the persistence, cache, thumbnail, export and
+ * drawing code paths, records the viewport area repainted by the gestures and writes the
+ * results as JSON, so that they can be compared across commits.
+ *
+ * The download paths are also checked: a failed check is recorded in the results and makes
+ * the run fail.
+ */
+class UBBenchmark
+{
+    public:
+        UBBenchmark(const QString& resultPath);
+        virtual ~UBBenchmark();
+
+        bool run();
+
+        static QString resultPathFromArguments(const QStringList& arguments);
+
+    private:
+
+        typedef std::function<void(std::shared_ptr<UBGraphicsScene>, int)> PageFiller;
+
+        void measure(const QString& name, int iterations, std::function<void()> operation, std::function<void()> prepare = nullptr);
+        void setResultValue(const QString& key, const QJsonValue& value);
+        void check(const QString& name, bool passed);
+
+        std::shared_ptr<UBDocumentProxy> createDocument(const QString& name, int pageCount, PageFiller filler);
+
+        static void addStrokes(std::shared_ptr<UBGraphicsScene> scene, int strokeCount, int seed);
+        static void addImages(std::shared_ptr<UBGraphicsScene> scene, int imageCount, int seed);
+        static void addWidgets(std::shared_ptr<UBGraphicsScene> scene, int widgetCount);
+        static void drawGesture(std::shared_ptr<UBGraphicsScene> scene, int tool, const QPointF& start, int pointCount);
+
+        QString createPdf(const QString& name, int pageCount, const QString& text);
+
+        void benchmarkSettings();
+        void benchmarkSvg(std::shared_ptr<UBDocumentProxy> document, const QString& name);
+        void benchmarkSceneCache(std::shared_ptr<UBDocumentProxy> document, const QString& name);
+        void benchmarkThumbnails(std::shared_ptr<UBDocumentProxy> document, const QString& name);
+        void benchmarkPdfExport(std::shared_ptr<UBDocumentProxy> document, const QString& name);
+        void benchmarkPdfMerger();
+        void benchmarkGestures();
+        void benchmarkUndo();
+        void benchmarkDownloads();
+
+        QString mResultPath;
+        bool mChecksPassed;
+        QTemporaryDir mWorkDir;
+        QJsonArray mResults;
+};
+
+#endif /* UBBENCHMARK_H_ */
@@ -0,0 +1,3 @@
+HEADERS     +=  src/benchmark/UBBenchmark.h
+
+SOURCES     +=  src/benchmark/UBBenchmark.cpp
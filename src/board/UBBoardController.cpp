@@ -43,6 +43,7 @@
 #include "core/UBDocumentManager.h"
 #include "core/UBMimeData.h"
 #include "core/UBDownloadManager.h"
+#include "core/UBTrace.h"
 
 #include "gui/UBMessageWindow.h"
 #include "gui/UBToolbarButtonGroup.h"
@@ -131,10 +132,10 @@ void UBBoardController::init()
     setupViews();
     setupToolbar();
 
-    connect(UBApplication::undoStack, SIGNAL(canUndoChanged(bool))
+    connect(UBApplication::undoGroup, SIGNAL(canUndoChanged(bool))
             , this, SLOT(undoRedoStateChange(bool)));
 
-    connect(UBApplication::undoStack, SIGNAL(canRedoChanged(bool))
+    connect(UBApplication::undoGroup, SIGNAL(canRedoChanged(bool))
             , this, SLOT(undoRedoStateChange(bool)));
 
     connect(UBDrawingController::drawingController(), SIGNAL(stylusToolChanged(int))
@@ -458,8 +459,8 @@ void UBBoardController::connectToolbar()
     connect(mMainWindow->actionEraseAnnotations, SIGNAL(triggered()), this, SLOT(clearSceneAnnotation()));
     connect(mMainWindow->actionEraseBackground,SIGNAL(triggered()),this,SLOT(clearSceneBackground()));
 
-    connect(mMainWindow->actionUndo, SIGNAL(triggered()), UBApplication::undoStack, SLOT(undo()));
-    connect(mMainWindow->actionRedo, SIGNAL(triggered()), UBApplication::undoStack, SLOT(redo()));
+    connect(mMainWindow->actionUndo, SIGNAL(triggered()), UBApplication::undoGroup, SLOT(undo()));
+    connect(mMainWindow->actionRedo, SIGNAL(triggered()), UBApplication::undoGroup, SLOT(redo()));
     connect(mMainWindow->actionRedo, SIGNAL(triggered()), this, SLOT(startScript()));
     connect(mMainWindow->actionBack, SIGNAL( triggered()), this, SLOT(previousScene()));
     connect(mMainWindow->actionForward, SIGNAL(triggered()), this, SLOT(nextScene()));
@@ -637,7 +638,13 @@ void UBBoardController::duplicateScene(int nIndex)
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
     persistCurrentScene(false,true);
 
-    duplicatePage(nIndex);
+    if (!duplicatePage(nIndex))
+    {
+        QApplication::restoreOverrideCursor();
+        UBApplication::showMessage(tr("Duplicate page operation failed"));
+        return;
+    }
+
     emit addThumbnailRequired(selectedDocument(), nIndex + 1);
     if (UBApplication::documentController->selectedDocument() == selectedDocument())
     {
@@ -762,8 +769,9 @@ UBGraphicsItem *UBBoardController::duplicateItem(UBItem *item)
                 QGraphicsItem * itemToGroup = dynamic_cast<QGraphicsItem *>(duplicateItem(pItem));
                 if (itemToGroup)
                 {
+                    // the duplicate is already in the scene, its z index must follow
+                    UBGraphicsItem::assignZValue(itemToGroup, pIt->data(UBGraphicsItemData::ItemOwnZValue).toReal());
                     itemToGroup->setZValue(pIt->zValue());
-                    itemToGroup->setData(UBGraphicsItemData::ItemOwnZValue, pIt->data(UBGraphicsItemData::ItemOwnZValue).toReal());
                     duplicatedItems.append(itemToGroup);
                 }
             }
@@ -1136,11 +1144,18 @@ void UBBoardController::downloadURL(const QUrl& url, QString contentSourceUrl, c
         QString fileName = formedUrl.toLocalFile();
         QString contentType = UBFileSystemUtils::mimeTypeFromFileName(fileName);
 
-        // directly add local file to document without copying
+        QString mimeType = contentType.section(';', 0, 0);
+        UBMimeType::Enum itemMimeType = UBFileSystemUtils::mimeTypeFromString(mimeType);
+
         QFile file(fileName);
         QByteArray data;
 
-        if (file.open(QIODevice::ReadOnly))
+        // media and PDF files are added to the document straight from disk, there is no need to load them
+        bool loadData = itemMimeType != UBMimeType::Video
+                && itemMimeType != UBMimeType::Audio
+                && itemMimeType != UBMimeType::PDF;
+
+        if (loadData && file.open(QIODevice::ReadOnly))
         {
             data = file.readAll();
         }
@@ -1176,6 +1191,14 @@ void UBBoardController::downloadURL(const QUrl& url, QString contentSourceUrl, c
 }
 
 
+bool UBBoardController::isInSelectedDocument(const QUrl& pUrl)
+{
+    return pUrl.isLocalFile()
+            && selectedDocument()
+            && pUrl.toLocalFile().startsWith(selectedDocument()->persistencePath() + "/");
+}
+
+
 UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader,
                                             QByteArray pData, QPointF pPos, QSize pSize,
                                             bool isBackground, bool internalData)
@@ -1324,15 +1347,16 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl
 
         UBGraphicsMediaItem *mediaVideoItem = 0;
         QUuid uuid = QUuid::createUuid();
-        if (pData.length() > 0)
+        if (pData.length() > 0 || (sourceUrl.isLocalFile() && !isInSelectedDocument(sourceUrl)))
         {
+            // local files are not loaded in memory, they are copied (or linked) into the document
             QString destFile;
             bool b = UBPersistenceManager::persistenceManager()->addFileToDocument(selectedDocument(),
-                sourceUrl.toString(),
+                pData.length() > 0 ? sourceUrl.toString() : sourceUrl.toLocalFile(),
                 UBPersistenceManager::videoDirectory,
                 uuid,
                 destFile,
-                &pData);
+                pData.length() > 0 ? &pData : NULL);
             if (!b)
             {
                 UBApplication::showMessage(tr("Add file operation failed: file copying error"));
@@ -1369,15 +1393,15 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QUrl
         UBGraphicsMediaItem *audioMediaItem = 0;
 
         QUuid uuid = QUuid::createUuid();
-        if (pData.length() > 0)
+        if (pData.length() > 0 || (sourceUrl.isLocalFile() && !isInSelectedDocument(sourceUrl)))
         {
             QString destFile;
             bool b = UBPersistenceManager::persistenceManager()->addFileToDocument(selectedDocument(),
-                sourceUrl.toString(),
+                pData.length() > 0 ? sourceUrl.toString() : sourceUrl.toLocalFile(),
                 UBPersistenceManager::audioDirectory,
                 uuid,
                 destFile,
-                &pData);
+                pData.length() > 0 ? &pData : NULL);
             if (!b)
             {
                 UBApplication::showMessage(tr("Add file operation failed: file copying error"));
@@ -1629,12 +1653,11 @@ std::shared_ptr<UBGraphicsScene> UBBoardController::setActiveDocumentScene(std::
         {
             persistCurrentScene();
             freezeW3CWidgets(true);
-            ClearUndoStack();
-        }else
-        {
-            UBApplication::undoStack->clear();
         }
 
+        // each page keeps its own history, switching only changes the active stack
+        activatePageUndoStack(targetScene);
+
         mActiveScene = targetScene;
         mActiveSceneIndex = index;
 
@@ -1644,11 +1667,11 @@ std::shared_ptr<UBGraphicsScene> UBBoardController::setActiveDocumentScene(std::
 
         if (mControlView->scene())
         {
-            disconnect(UBApplication::undoStack.data(), SIGNAL(indexChanged(int)), mControlView->scene().get(), SLOT(updateSelectionFrameWrapper(int)));
+            disconnect(UBApplication::undoGroup.data(), SIGNAL(indexChanged(int)), mControlView->scene().get(), SLOT(updateSelectionFrameWrapper(int)));
         }
 
         mControlView->setScene(mActiveScene.get());
-        connect(UBApplication::undoStack.data(), SIGNAL(indexChanged(int)), mControlView->scene().get(), SLOT(updateSelectionFrameWrapper(int)));
+        connect(UBApplication::undoGroup.data(), SIGNAL(indexChanged(int)), mControlView->scene().get(), SLOT(updateSelectionFrameWrapper(int)));
 
         mDisplayView->setScene(mActiveScene.get());
         mActiveScene->setBackgroundZoomFactor(mControlView->transform().m11());
@@ -1780,10 +1803,71 @@ void UBBoardController::findUniquesItems(const QUndoCommand *parent, QSet<QGraph
 
 void UBBoardController::ClearUndoStack()
 {
+    // clear the history of every page
+    foreach (const PageUndoStack& pageStack, mPageUndoStacks)
+    {
+        clearUndoStack(pageStack.stack, pageStack.scene.lock());
+    }
+
+    // history recorded before any page was activated
+    clearUndoStack(UBApplication::undoStack, mActiveScene);
+}
+
+void UBBoardController::activatePageUndoStack(std::shared_ptr<UBGraphicsScene> scene)
+{
+    // the commands hold the scene they apply to, so a page keeps its history only while
+    // the scene cache keeps its scene, otherwise the history would keep evicted or reloaded scenes alive
+    for (int i = mPageUndoStacks.size() - 1; i >= 0; i--)
+    {
+        std::shared_ptr<UBGraphicsScene> pageScene = mPageUndoStacks.at(i).scene.lock();
+
+        if (pageScene != scene && !UBPersistenceManager::persistenceManager()->isSceneInCached(pageScene))
+        {
+            PageUndoStack evicted = mPageUndoStacks.takeAt(i);
+            clearUndoStack(evicted.stack, pageScene);
+            delete evicted.stack;
+        }
+    }
+
+    // most recently used first, the list is bounded by the cache size so a linear lookup is enough
+    QUndoStack* stack = nullptr;
+
+    for (int i = 0; i < mPageUndoStacks.size(); i++)
+    {
+        std::shared_ptr<UBGraphicsScene> pageScene = mPageUndoStacks.at(i).scene.lock();
+
+        if (pageScene == scene)
+        {
+            stack = mPageUndoStacks.at(i).stack;
+            mPageUndoStacks.move(i, 0);
+            break;
+        }
+    }
+
+    if (!stack)
+    {
+        stack = new QUndoStack(this);
+        UBApplication::undoGroup->addStack(stack);
+
+        PageUndoStack pageStack;
+        pageStack.scene = scene;
+        pageStack.stack = stack;
+        mPageUndoStacks.prepend(pageStack);
+    }
+
+    UBApplication::undoStack = stack;
+    UBApplication::undoGroup->setActiveStack(stack);
+}
+
+void UBBoardController::clearUndoStack(QUndoStack* stack, std::shared_ptr<UBGraphicsScene> owner)
+{
+    if (!stack)
+        return;
+
     QSet<QGraphicsItem*> uniqueItems;
     // go through all stack command
-    for (int i = 0; i < UBApplication::undoStack->count(); i++) {
-        findUniquesItems(UBApplication::undoStack->command(i), uniqueItems);
+    for (int i = 0; i < stack->count(); i++) {
+        findUniquesItems(stack->command(i), uniqueItems);
     }
 
     // Get items from clipboard in order not to delete an item that was cut
@@ -1821,7 +1905,7 @@ void UBBoardController::ClearUndoStack()
 
         if(!scene && !inClipboard)
         {
-            if (!mActiveScene->deleteItem(item)){
+            if (!owner || !owner->deleteItem(item)){
                 delete item;
                 item = 0;
             }
@@ -1829,7 +1913,7 @@ void UBBoardController::ClearUndoStack()
     }
 
     // clear stack, and command list
-    UBApplication::undoStack->clear();
+    stack->clear();
 }
 
 void UBBoardController::adjustDisplayViews()
@@ -1927,8 +2011,8 @@ void UBBoardController::undoRedoStateChange(bool canUndo)
 {
     Q_UNUSED(canUndo);
 
-    mMainWindow->actionUndo->setEnabled(UBApplication::undoStack->canUndo());
-    mMainWindow->actionRedo->setEnabled(UBApplication::undoStack->canRedo());
+    mMainWindow->actionUndo->setEnabled(UBApplication::undoGroup->canUndo());
+    mMainWindow->actionRedo->setEnabled(UBApplication::undoGroup->canRedo());
 
     updateActionStates();
 }
@@ -1975,6 +2059,8 @@ void UBBoardController::autosaveTimeout()
         return;
     }
 
+    UB_TRACE_SCOPE("persistence", "autosave");
+
     saveData(sf_showProgress);
     UBSettings::settings()->save();
 }
@@ -2622,7 +2708,11 @@ void UBBoardController::processMimeData(const QMimeData* pMimeData, const QPoint
                 downloadURL(QUrl(qsTmp), QString(), pPos);
             else{
                 if(mActiveScene->selectedItems().count() && mActiveScene->selectedItems().at(0)->type() == UBGraphicsItemType::TextItemType)
-                    dynamic_cast<UBGraphicsTextItem*>(mActiveScene->selectedItems().at(0))->setHtml(pMimeData->text());
+                {
+                    UBGraphicsTextItem* textItem = dynamic_cast<UBGraphicsTextItem*>(mActiveScene->selectedItems().at(0));
+                    textItem->setHtml(pMimeData->text());
+                    textItem->contentsChanged();
+                }
                 else
                     mActiveScene->addTextHtml("", pPos)->setHtml(pMimeData->text());
             }
@@ -180,6 +180,9 @@ class UBBoardController : public UBDocumentContainer
         void displayMetaData(QMap<QString, QString> metadatas);
 
         void findUniquesItems(const QUndoCommand *parent, QSet<QGraphicsItem *> &items);
+        /**
+         * Clear the undo history of all the pages and delete the items only referenced by it.
+         */
         void ClearUndoStack();
         std::shared_ptr<UBGraphicsScene> setActiveDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int pSceneIndex = 0, bool forceReload = false, bool onImport = false);
         std::shared_ptr<UBGraphicsScene> setActiveDocumentScene(int pSceneIndex);
@@ -299,6 +302,18 @@ class UBBoardController : public UBDocumentContainer
         void updatePageSizeState();
         void saveViewState();
         int autosaveTimeoutFromSettings();
+        bool isInSelectedDocument(const QUrl& pUrl);
+        void activatePageUndoStack(std::shared_ptr<UBGraphicsScene> scene);
+        void clearUndoStack(QUndoStack* stack, std::shared_ptr<UBGraphicsScene> owner);
+
+        struct PageUndoStack
+        {
+            std::weak_ptr<UBGraphicsScene> scene;
+            QUndoStack* stack;
+        };
+
+        // histories of the visited pages still in the scene cache, most recent first
+        QList<PageUndoStack> mPageUndoStacks;
 
         UBMainWindow *mMainWindow;
         std::shared_ptr<UBGraphicsScene> mActiveScene;
@@ -45,6 +45,7 @@
 #include "core/UBSetting.h"
 #include "core/UBPersistenceManager.h"
 #include "core/UB.h"
+#include "core/UBTrace.h"
 
 #include "network/UBHttpGet.h"
 
@@ -335,6 +336,8 @@ bool UBBoardView::event (QEvent * e)
 
 void UBBoardView::tabletEvent (QTabletEvent * event)
 {
+    UB_TRACE_SCOPE("input", "tabletEvent");
+
     if (!mUseHighResTabletEvent) {
         event->setAccepted (false);
         return;
@@ -903,6 +906,126 @@ void UBBoardView::handleItemMouseMove(QMouseEvent *event)
     }
 }
 
+/**
+ * @brief Selects the items entering the rubber band and deselects the ones leaving it.
+ *
+ * Only the items intersecting the difference between the previous band and the current one
+ * are looked up, and the selection changes are applied in one batch.
+ */
+void UBBoardView::updateRubberBandSelection(const QRect& bandRect)
+{
+    bool isFirstMove = mSelectionBandRect.isNull();
+    bool selects = UBDrawingController::drawingController()->stylusTool() == UBStylusTool::Selector;
+
+    QSet<QGraphicsItem*> candidates;
+    for (const QRect& rect : QRegion(bandRect).xored(QRegion(mSelectionBandRect)))
+    {
+        foreach (QGraphicsItem *item, items(rect))
+            candidates.insert(item);
+    }
+
+    QPainterPath bandPath;
+    bandPath.addPolygon(mapToScene(bandRect));
+    bandPath.closeSubpath();
+
+    QSet<QGraphicsItem*> changedItems;
+    foreach (QGraphicsItem *item, candidates)
+    {
+        bool isInBand = item->collidesWithPath(item->mapFromScene(bandPath), Qt::IntersectsItemShape);
+
+        if (isInBand == mSelectionBandItems.contains(item))
+            continue;
+
+        QGraphicsItem *selectableItem = selects ? rubberBandSelectableItem(item) : 0;
+
+        if (isInBand)
+        {
+            mSelectionBandItems.insert(item);
+
+            if (selectableItem)
+                ++mSelectionBandHits[selectableItem];
+        }
+        else
+        {
+            mSelectionBandItems.remove(item);
+
+            if (selectableItem && --mSelectionBandHits[selectableItem] <= 0)
+                mSelectionBandHits.remove(selectableItem);
+        }
+
+        if (selectableItem)
+            changedItems.insert(selectableItem);
+    }
+
+    mSelectionBandRect = bandRect;
+
+    // items selected by a previous band are deselected unless the new one reaches them
+    if (isFirstMove)
+        changedItems.unite(mJustSelectedItems);
+
+    QList<QGraphicsItem*> itemsToSelect;
+    QList<QGraphicsItem*> itemsToDeselect;
+
+    foreach (QGraphicsItem *item, changedItems)
+    {
+        bool isHit = mSelectionBandHits.contains(item);
+
+        if (isHit && !mJustSelectedItems.contains(item))
+            itemsToSelect << item;
+        else if (!isHit && mJustSelectedItems.contains(item))
+            itemsToDeselect << item;
+    }
+
+    if (itemsToSelect.isEmpty() && itemsToDeselect.isEmpty())
+        return;
+
+    {
+        // a single selectionChanged() for the whole batch
+        QSignalBlocker blocker(scene());
+
+        foreach (QGraphicsItem *item, itemsToDeselect)
+        {
+            item->setSelected(false);
+            mJustSelectedItems.remove(item);
+        }
+
+        foreach (QGraphicsItem *item, itemsToSelect)
+        {
+            item->setSelected(true);
+            mJustSelectedItems.insert(item);
+        }
+    }
+
+    emit scene()->selectionChanged();
+}
+
+void UBBoardView::resetRubberBandSelection()
+{
+    mSelectionBandRect = QRect();
+    mSelectionBandItems.clear();
+    mSelectionBandHits.clear();
+}
+
+QGraphicsItem* UBBoardView::rubberBandSelectableItem(QGraphicsItem *item) const
+{
+    if (item->type() == UBGraphicsItemType::PolygonItemType && item->parentItem())
+        item = item->parentItem();
+
+    if (item->type() == UBGraphicsW3CWidgetItem::Type
+            || item->type() == UBGraphicsPixmapItem::Type
+            || item->type() == UBGraphicsVideoItem::Type
+            || item->type() == UBGraphicsAudioItem::Type
+            || item->type() == UBGraphicsSvgItem::Type
+            || item->type() == UBGraphicsTextItem::Type
+            || item->type() == UBGraphicsStrokesGroup::Type
+            || item->type() == UBGraphicsGroupContainerItem::Type)
+    {
+        return item;
+    }
+
+    return 0;
+}
+
 void UBBoardView::rubberItems()
 {
     if (mUBRubberBand)
@@ -1071,6 +1194,8 @@ void UBBoardView::longPressEvent()
 
 void UBBoardView::mousePressEvent (QMouseEvent *event)
 {
+    UB_TRACE_SCOPE("input", "mousePress");
+
     if (!bIsControl && !bIsDesktop) {
         event->ignore();
         return;
@@ -1091,6 +1216,7 @@ void UBBoardView::mousePressEvent (QMouseEvent *event)
     QPointF eventPosition = event->localPos();
 #endif
     mMouseDownPos = eventPosition.toPoint();
+    resetRubberBandSelection();
 
     setMovingItem(scene()->itemAt(this->mapToScene(eventPosition.toPoint()), QTransform()));
 
@@ -1217,6 +1343,8 @@ void UBBoardView::mousePressEvent (QMouseEvent *event)
 
 void UBBoardView::mouseMoveEvent (QMouseEvent *event)
 {
+    UB_TRACE_SCOPE("input", "mouseMove");
+
     //    static QTime lastCallTime;
     //    if (!lastCallTime.isNull()) {
     //        qDebug() << "time interval is " << lastCallTime.msecsTo(QTime::currentTime());
@@ -1280,52 +1408,7 @@ void UBBoardView::mouseMoveEvent (QMouseEvent *event)
             mUBRubberBand->setGeometry(bandRect);
             mUBRubberBand->show();
 
-            //          QTime startTime = QTime::currentTime();
-            //          QTime testTime = QTime::currentTime();
-            QList<QGraphicsItem *> rubberItems = items(bandRect);
-            //          qDebug() << "==================";
-            //          qDebug() << "| ====rubber items" << testTime.msecsTo(QTime::currentTime());
-            //          testTime = QTime::currentTime();
-            foreach (QGraphicsItem *item, mJustSelectedItems) {
-                if (!rubberItems.contains(item)) {
-                    item->setSelected(false);
-                    mJustSelectedItems.remove(item);
-                }
-            }
-            //          qDebug() << "| ===foreach length" << testTime.msecsTo(QTime::currentTime());
-            //          testTime = QTime::currentTime();
-
-            int counter = 0;
-            if (currentTool == UBStylusTool::Selector) {
-                foreach (QGraphicsItem *item, items(bandRect)) {
-
-                    if(item->type() == UBGraphicsItemType::PolygonItemType && item->parentItem())
-                        item = item->parentItem();
-
-                    if (item->type() == UBGraphicsW3CWidgetItem::Type
-                            || item->type() == UBGraphicsPixmapItem::Type
-                            || item->type() == UBGraphicsVideoItem::Type
-                            || item->type() == UBGraphicsAudioItem::Type
-                            || item->type() == UBGraphicsSvgItem::Type
-                            || item->type() == UBGraphicsTextItem::Type
-                            || item->type() == UBGraphicsStrokesGroup::Type
-                            || item->type() == UBGraphicsGroupContainerItem::Type) {
-
-
-                        if (!mJustSelectedItems.contains(item)) {
-                            counter++;
-                            item->setSelected(true);
-                            mJustSelectedItems.insert(item);
-                        }
-                    }
-                }
-            }
-
-            //          qDebug() << "| ==selected items count" << counter << '\n'
-            //                   << "| ==selection time" << testTime.msecsTo(QTime::currentTime()) << '\n'
-            //                   << "| =elapsed time " << startTime.msecsTo(QTime::currentTime()) << '\n'
-            //                   << "==================";
-            //          QCoreApplication::removePostedEvents(scene(), 0);
+            updateRubberBandSelection(bandRect);
         }
         handleItemMouseMove(event);
     } break;
@@ -1360,6 +1443,8 @@ void UBBoardView::movingItemDestroyed(QObject*)
 
 void UBBoardView::mouseReleaseEvent (QMouseEvent *event)
 {
+    UB_TRACE_SCOPE("input", "mouseRelease");
+
     UBStylusTool::Enum currentTool = (UBStylusTool::Enum)UBDrawingController::drawingController ()->stylusTool ();
 
     setToolCursor (currentTool);
@@ -1669,7 +1754,7 @@ void UBBoardView::wheelEvent (QWheelEvent *wheelEvent)
     if (wheelEvent->modifiers() == Qt::ControlModifier && wheelEvent->angleDelta().x() == 0)
     {
         qreal angle = wheelEvent->angleDelta().y();
-        qreal zoomBase = UBSettings::settings()->boardZoomBase->get().toDouble();
+        qreal zoomBase = UBSettings::settings()->boardZoomBase->getReal();
         qreal zoomFactor = qPow(zoomBase, angle);
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
         mController->zoom(zoomFactor, mapToScene(wheelEvent->position().toPoint()));
@@ -1722,6 +1807,7 @@ void UBBoardView::leaveEvent (QEvent * event)
         scene ()->leaveEvent (event);
 
     mJustSelectedItems.clear();
+    resetRubberBandSelection();
 
     QGraphicsView::leaveEvent (event);
 }
@@ -1826,7 +1912,21 @@ void UBBoardView::resizeEvent (QResizeEvent * event)
 
 void UBBoardView::paintEvent(QPaintEvent *event)
 {
-    QGraphicsView::paintEvent(event);
+    {
+        UB_TRACE_SCOPE_SAMPLED("board", "paint", "board.paint_us");
+        QGraphicsView::paintEvent(event);
+    }
+
+    qint64 repaintedArea = 0;
+
+    for (const QRect& rect : event->region())
+    {
+        repaintedArea += qint64(rect.width()) * rect.height();
+    }
+
+    // the pixels repainted per trace interval show how partial the viewport updates are
+    mRepaintedArea += repaintedArea;
+    UBTrace::count("board.repainted_px", repaintedArea);
 
     // ignore paint events under the left palette
     int paletteWidth = UBApplication::boardController->paletteManager()->leftPalette()->width();
@@ -69,6 +69,10 @@ public:
     void setBoxing(const QMargins& margins);
     void updateSnapIndicator(Qt::Corner corner, QPointF snapPoint);
 
+    // number of viewport pixels repainted since the last reset, to compare viewport update strategies
+    qint64 repaintedArea() const { return mRepaintedArea; }
+    void resetRepaintedArea() { mRepaintedArea = 0; }
+
     // work around for handling tablet events on MAC OS with Qt 4.8.0 and above
 #if defined(Q_OS_OSX)
     bool directTabletEvent(QEvent *event);
@@ -161,6 +165,10 @@ private:
 
     bool isAbsurdPoint(QPoint point);
 
+    void updateRubberBandSelection(const QRect& bandRect);
+    void resetRubberBandSelection();
+    QGraphicsItem* rubberBandSelectableItem(QGraphicsItem* item) const;
+
     bool mVirtualKeyboardActive;
     bool mOkOnWidget;
 
@@ -200,6 +208,12 @@ private:
     QList<QGraphicsItem *> mRubberedItems;
     QSet<QGraphicsItem*> mJustSelectedItems;
 
+    // rubber band of the previous mouse move, the items it intersects
+    // and how many of them belong to each selectable item
+    QRect mSelectionBandRect;
+    QSet<QGraphicsItem*> mSelectionBandItems;
+    QHash<QGraphicsItem*, int> mSelectionBandHits;
+
     int mLongPressInterval;
     QTimer mLongPressTimer;
 
@@ -211,6 +225,7 @@ private:
 
     QMargins mMargins{};
     UBSnapIndicator* mSnapIndicator{nullptr};
+    qint64 mRepaintedArea{0};
 
     static bool hasSelectedParents(QGraphicsItem * item);
 
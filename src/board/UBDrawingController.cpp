@@ -151,17 +151,6 @@ void UBDrawingController::setStylusTool(int tool)
             UBApplication::mainWindow->actionCapture->setChecked(true);
 
 
-        // workaround for #827
-        // glitches when moving objects fast
-        if (mStylusTool == UBStylusTool::Selector || mStylusTool == UBStylusTool::Play)
-        {
-            UBApplication::boardController->controlView()->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
-        }
-        else
-        {
-            UBApplication::boardController->controlView()->setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
-        }
-
         emit stylusToolChanged(tool, previousTool);
         if (mStylusTool != UBStylusTool::Selector)
             emit colorPaletteChanged();
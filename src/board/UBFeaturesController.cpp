@@ -64,40 +64,48 @@ const QString UBFeaturesController::favoritePath = rootPath + "/Favorites";
 const QString UBFeaturesController::webSearchPath = rootPath + "/Web search";
 
 
+namespace
+{
+    // number of features and maximum delay (ms) before a batch is sent to the GUI thread
+    const int featuresBatchSize = 128;
+    const int featuresBatchInterval = 100;
+
+    QString libraryIconCacheDirectory()
+    {
+        return UBSettings::userDataDirectory() + "/libraryIconCache";
+    }
+}
+
 void UBFeaturesComputingThread::scanFS(const QUrl & currentPath, const QString & currVirtualPath, const QSet<QUrl> &pFavoriteSet)
 {
-//    Q_ASSERT(QFileInfo(currentPath.toLocalFile()).exists());
-//    if(QFileInfo(currentPath.toLocalFile()).exists())
-//        return;
+    emit directoryScanned(currentPath.toLocalFile(), currVirtualPath);
 
-    QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(currentPath.toLocalFile());
+    const QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(currentPath.toLocalFile());
 
-    QFileInfoList::iterator fileInfo;
-    for ( fileInfo = fileInfoList.begin(); fileInfo != fileInfoList.end(); fileInfo +=  1) {
-        if (abort) {
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        if (abort || restart) {
             return;
         }
 
-        QString fullFileName = fileInfo->absoluteFilePath();
-        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
-        QString fileName = fileInfo->fileName();
-
-        QImage icon = UBFeaturesController::getIcon(fullFileName, featureType);
+        QString fullFileName = fileInfo.absoluteFilePath();
 
         if ( fullFileName.contains(".thumbnail."))
             continue;
 
-        UBFeature testFeature(currVirtualPath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
+        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
+        QString fileName = fileInfo.fileName();
+
+        QImage icon = UBFeaturesController::getIcon(fullFileName, featureType);
 
-        emit sendFeature(testFeature);
-        emit featureSent();
-        emit scanPath(fullFileName);
+        mPendingFeatures << UBFeature(currVirtualPath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
 
         if ( pFavoriteSet.find(QUrl::fromLocalFile(fullFileName)) != pFavoriteSet.end()) {
             //TODO send favoritePath from the controller or make favoritePath public and static
-            emit sendFeature(UBFeature( UBFeaturesController::favoritePath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType));
+            mPendingFeatures << UBFeature( UBFeaturesController::favoritePath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
         }
 
+        flushFeatures(false);
+
         if (featureType == FEATURE_FOLDER) {
             scanFS(QUrl::fromLocalFile(fullFileName), currVirtualPath + "/" + fileName, pFavoriteSet);
         }
@@ -107,7 +115,7 @@ void UBFeaturesComputingThread::scanFS(const QUrl & currentPath, const QString &
 void UBFeaturesComputingThread::scanAll(QList<QPair<QUrl, UBFeature> > pScanningData, const QSet<QUrl> &pFavoriteSet)
 {
     for (int i = 0; i < pScanningData.count(); i++) {
-        if (abort) {
+        if (abort || restart) {
             return;
         }
         QPair<QUrl, UBFeature> curPair = pScanningData.at(i);
@@ -115,55 +123,48 @@ void UBFeaturesComputingThread::scanAll(QList<QPair<QUrl, UBFeature> > pScanning
         emit scanCategory(curPair.second.getDisplayName());
         scanFS(curPair.first, curPair.second.getFullVirtualPath(), pFavoriteSet);
     }
+
+    flushFeatures(true);
 }
 
-int UBFeaturesComputingThread::featuresCount(const QUrl &pPath)
+void UBFeaturesComputingThread::flushFeatures(bool pForce)
 {
-    int noItems = 0;
-
-    QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(pPath.toLocalFile());
-
-    QFileInfoList::iterator fileInfo;
-    for ( fileInfo = fileInfoList.begin(); fileInfo != fileInfoList.end(); fileInfo +=  1) {
-        QString fullFileName = fileInfo->absoluteFilePath();
-        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
-
-        if (featureType != FEATURE_INVALID && !fullFileName.contains(".thumbnail.")) {
-            noItems++;
-        }
-
-        if (featureType == FEATURE_FOLDER) {
-            noItems += featuresCount(QUrl::fromLocalFile(fullFileName));
-        }
+    if (mPendingFeatures.isEmpty()) {
+        return;
     }
 
-    return noItems;
-}
-
-int UBFeaturesComputingThread::featuresCountAll(QList<QPair<QUrl, UBFeature> > pScanningData)
-{
-    int noItems = 0;
-    for (int i = 0; i < pScanningData.count(); i++) {
-        QPair<QUrl, UBFeature> curPair = pScanningData.at(i);
-        noItems += featuresCount(curPair.first);
+    if (!pForce && mPendingFeatures.count() < featuresBatchSize && mBatchTimer.elapsed() < featuresBatchInterval) {
+        return;
     }
 
-    return noItems;
+    emit sendFeatures(mPendingFeatures, mScanningGeneration);
+    emit scanPath(mPendingFeatures.last().getFullPath().toLocalFile());
+
+    mPendingFeatures.clear();
+    mBatchTimer.restart();
 }
 
 UBFeaturesComputingThread::UBFeaturesComputingThread(QObject *parent) :
 QThread(parent)
 {
+    mGeneration = 0;
+    mScanningGeneration = 0;
+    mScanRequested = false;
     restart = false;
     abort = false;
 }
 
-void UBFeaturesComputingThread::compute(const QList<QPair<QUrl, UBFeature> > &pScanningData, QSet<QUrl> *pFavoritesSet)
+int UBFeaturesComputingThread::compute(const QList<QPair<QUrl, UBFeature> > &pScanningData, QSet<QUrl> *pFavoritesSet)
 {
     QMutexLocker curLocker(&mMutex);
 
     mScanningData = pScanningData;
     mFavoriteSet = *pFavoritesSet;
+    ++mGeneration;
+
+    // a full scan supersedes the pending directory updates
+    mScanRequested = true;
+    mDirectoryJobs.clear();
 
     if (!isRunning()) {
         start(LowPriority);
@@ -171,52 +172,123 @@ void UBFeaturesComputingThread::compute(const QList<QPair<QUrl, UBFeature> > &pS
         restart = true;
         mWaitCondition.wakeOne();
     }
+
+    return mGeneration;
 }
 
-void UBFeaturesComputingThread::run()
+void UBFeaturesComputingThread::computeDirectory(const QString &pPath, const QString &pVirtualPath, const QSet<QString> &pKnownFiles, QSet<QUrl> *pFavoritesSet)
 {
-    forever {
-//        qDebug() << "Custom thread started execution";
+    QMutexLocker curLocker(&mMutex);
 
-        mMutex.lock();
-        QList<QPair<QUrl, UBFeature> > searchData = mScanningData;
-        QSet<QUrl> favoriteSet = mFavoriteSet;
-        mMutex.unlock();
+    DirectoryJob job;
+    job.path = pPath;
+    job.virtualPath = pVirtualPath;
+    job.knownFiles = pKnownFiles;
+    mDirectoryJobs << job;
+    mFavoriteSet = *pFavoritesSet;
 
-        if (abort) {
+    if (!isRunning()) {
+        start(LowPriority);
+    } else {
+        mWaitCondition.wakeOne();
+    }
+}
+
+void UBFeaturesComputingThread::scanDirectory(const DirectoryJob &pJob, const QSet<QUrl> &pFavoriteSet)
+{
+    QStringList files;
+    QList<UBFeature> addedFeatures;
+    QList<QPair<QUrl, QString> > addedFolders;
+
+    const QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(pJob.path);
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        if (abort || restart) {
             return;
         }
-        if (restart) {
-            break;
+
+        QString fullFileName = fileInfo.absoluteFilePath();
+
+        if ( fullFileName.contains(".thumbnail."))
+            continue;
+
+        files << fullFileName;
+
+        QString fileName = fileInfo.fileName();
+
+        if (pJob.knownFiles.contains(fullFileName)) {
+            if (fileInfo.isDir()) {
+                emit directoryScanned(fullFileName, pJob.virtualPath + "/" + fileName);
+            }
+            continue;
+        }
+
+        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
+        QImage icon = UBFeaturesController::getIcon(fullFileName, featureType);
+
+        addedFeatures << UBFeature(pJob.virtualPath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
+
+        if (pFavoriteSet.contains(QUrl::fromLocalFile(fullFileName))) {
+            addedFeatures << UBFeature(UBFeaturesController::favoritePath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
         }
 
-//        QTime curTime = QTime::currentTime();
-        int fsCnt = featuresCountAll(searchData);
-//        int msecsto = curTime.msecsTo(QTime::currentTime());
-//        qDebug() << "time on evaluation" << msecsto;
+        if (featureType == FEATURE_FOLDER) {
+            addedFolders << QPair<QUrl, QString>(QUrl::fromLocalFile(fullFileName), pJob.virtualPath + "/" + fileName);
+        }
+    }
 
-        emit maxFilesCountEvaluated(fsCnt);
+    emit directoryUpdated(pJob.path, files, addedFeatures, mScanningGeneration);
 
-        emit scanStarted();
-//        curTime = QTime::currentTime();
-        scanAll(searchData, favoriteSet);
-//        qDebug() << "Time on finishing" << curTime.msecsTo(QTime::currentTime());
-        emit scanFinished();
+    // the content of a new folder is not known yet
+    for (const QPair<QUrl, QString> &folder : std::as_const(addedFolders)) {
+        scanFS(folder.first, folder.second, pFavoriteSet);
+    }
+
+    flushFeatures(true);
+}
 
+void UBFeaturesComputingThread::run()
+{
+    forever {
         mMutex.lock();
-        if (!abort) {
+        while (!abort && !mScanRequested && mDirectoryJobs.isEmpty()) {
             mWaitCondition.wait(&mMutex);
         }
+
+        if (abort) {
+            mMutex.unlock();
+            return;
+        }
+
+        bool scanRequested = mScanRequested;
+        QList<QPair<QUrl, UBFeature> > searchData = mScanningData;
+        QList<DirectoryJob> directoryJobs = mDirectoryJobs;
+        QSet<QUrl> favoriteSet = mFavoriteSet;
+        mScanningGeneration = mGeneration;
+        mScanRequested = false;
+        mDirectoryJobs.clear();
         restart = false;
         mMutex.unlock();
 
+        mPendingFeatures.clear();
+        mBatchTimer.start();
+
+        if (scanRequested) {
+            // the tree is walked only once, so the total is unknown: ask for a busy indicator
+            emit maxFilesCountEvaluated(0);
+
+            emit scanStarted();
+            scanAll(searchData, favoriteSet);
+            emit scanFinished();
+        } else {
+            for (const DirectoryJob &job : std::as_const(directoryJobs)) {
+                scanDirectory(job, favoriteSet);
+            }
+        }
     }
 }
 
 UBFeaturesComputingThread::~UBFeaturesComputingThread()
 {
-//    qDebug() <<  "thread destructor catched";
-
     mMutex.lock();
     abort = true;
     mWaitCondition.wakeOne();
@@ -315,6 +387,7 @@ UBFeaturesController::UBFeaturesController(QWidget *pParentWidget) :
     QObject(pParentWidget)
     ,featuresList(0)
     ,mLastItemOffsetIndex(0)
+    ,mScanGeneration(0)
 {
     //Initializing physical directories from UBSettings
     mUserAudioDirectoryPath = QUrl::fromLocalFile(UBSettings::settings()->userAudioDirectory());
@@ -367,8 +440,17 @@ UBFeaturesController::UBFeaturesController(QWidget *pParentWidget) :
     featuresPathModel->setSourceModel(featuresModel);
 
     connect(featuresModel, SIGNAL(dataRestructured()), featuresProxyModel, SLOT(invalidate()));
-    connect(&mCThread, SIGNAL(sendFeature(UBFeature)), featuresModel, SLOT(addItem(UBFeature)));
-    connect(&mCThread, SIGNAL(featureSent()), this, SIGNAL(featureAddedFromThread()));
+    mFileSystemWatcher = new QFileSystemWatcher(this);
+    mChangedDirectoriesTimer = new QTimer(this);
+    mChangedDirectoriesTimer->setSingleShot(true);
+    mChangedDirectoriesTimer->setInterval(250);
+
+    connect(mFileSystemWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+    connect(mChangedDirectoriesTimer, SIGNAL(timeout()), this, SLOT(updateChangedDirectories()));
+
+    connect(&mCThread, SIGNAL(sendFeatures(QList<UBFeature>,int)), this, SLOT(addFeaturesFromThread(QList<UBFeature>,int)));
+    connect(&mCThread, SIGNAL(directoryScanned(QString,QString)), this, SLOT(watchDirectory(QString,QString)));
+    connect(&mCThread, SIGNAL(directoryUpdated(QString,QStringList,QList<UBFeature>,int)), this, SLOT(directoryUpdatedFromThread(QString,QStringList,QList<UBFeature>,int)));
     connect(&mCThread, SIGNAL(scanStarted()), this, SIGNAL(scanStarted()));
     connect(&mCThread, SIGNAL(scanFinished()), this, SIGNAL(scanFinished()));
     connect(&mCThread, SIGNAL(maxFilesCountEvaluated(int)), this, SIGNAL(maxFilesCountEvaluated(int)));
@@ -400,7 +482,120 @@ void UBFeaturesController::startThread()
             <<  QPair<QUrl, UBFeature>(trashDirectoryPath, trashElement)
             <<  QPair<QUrl, UBFeature>(mLibSearchDirectoryPath, webSearchElement);
 
-    mCThread.compute(computingData, favoriteSet);
+    mScanGeneration = mCThread.compute(computingData, favoriteSet);
+}
+
+void UBFeaturesController::addFeaturesFromThread(const QList<UBFeature> &pFeatures, int pGeneration)
+{
+    // batches of an interrupted scan may still be queued when a new one starts
+    if (pGeneration != mScanGeneration) {
+        return;
+    }
+
+    featuresModel->addItems(pFeatures);
+}
+
+void UBFeaturesController::watchDirectory(const QString &pPath, const QString &pVirtualPath)
+{
+    const QString path = QDir(pPath).absolutePath();
+
+    if (!mWatchedDirectories.contains(path) && QFileInfo(path).isDir()) {
+        mFileSystemWatcher->addPath(path);
+    }
+
+    mWatchedDirectories.insert(path, pVirtualPath);
+}
+
+void UBFeaturesController::directoryChanged(const QString &pPath)
+{
+    // a single operation (copy, unzip, ...) usually triggers a burst of notifications
+    mChangedDirectories.insert(QDir(pPath).absolutePath());
+    mChangedDirectoriesTimer->start();
+}
+
+void UBFeaturesController::updateChangedDirectories()
+{
+    const QSet<QString> changedDirectories = mChangedDirectories;
+    mChangedDirectories.clear();
+
+    for (const QString &path : changedDirectories) {
+        updateDirectory(path);
+    }
+}
+
+QSet<QString> UBFeaturesController::knownFiles(const QString &pPath, const QString &pVirtualPath) const
+{
+    QSet<QString> files;
+
+    for (const UBFeature &feature : std::as_const(*featuresList)) {
+        if (feature.getVirtualPath() == pVirtualPath && feature.getFullPath().isLocalFile()) {
+            const QString localFile = feature.getFullPath().toLocalFile();
+            if (QFileInfo(localFile).absolutePath() == pPath) {
+                files.insert(localFile);
+            }
+        }
+    }
+
+    return files;
+}
+
+void UBFeaturesController::updateDirectory(const QString &pPath)
+{
+    if (!mWatchedDirectories.contains(pPath)) {
+        return;
+    }
+
+    if (!QFileInfo(pPath).isDir()) {
+        // the removal itself is reported by the parent directory
+        mWatchedDirectories.remove(pPath);
+        mFileSystemWatcher->removePath(pPath);
+        return;
+    }
+
+    // the directory is listed and the icons of new files are decoded by the computing thread
+    mCThread.computeDirectory(pPath, mWatchedDirectories.value(pPath), knownFiles(pPath, mWatchedDirectories.value(pPath)), favoriteSet);
+}
+
+void UBFeaturesController::directoryUpdatedFromThread(const QString &pPath, const QStringList &pFiles, const QList<UBFeature> &pAddedFeatures, int pGeneration)
+{
+    if (pGeneration != mScanGeneration || !mWatchedDirectories.contains(pPath)) {
+        return;
+    }
+
+    const QString virtualPath = mWatchedDirectories.value(pPath);
+    QSet<QString> files;
+    for (const QString &file : pFiles) {
+        files.insert(file);
+    }
+
+    const QSet<QString> known = knownFiles(pPath, virtualPath);
+
+    // what is not listed anymore was removed from disk behind our back
+    QList<UBFeature> removedFeatures;
+    for (const UBFeature &feature : std::as_const(*featuresList)) {
+        if (feature.getVirtualPath() == virtualPath && feature.getFullPath().isLocalFile()) {
+            const QString localFile = feature.getFullPath().toLocalFile();
+            if (QFileInfo(localFile).absolutePath() == pPath && !files.contains(localFile)) {
+                removedFeatures << feature;
+            }
+        }
+    }
+
+    for (const UBFeature &feature : std::as_const(removedFeatures)) {
+        featuresModel->deleteItem(feature);
+    }
+
+    // another update of the directory may have added the same files meanwhile
+    QList<UBFeature> addedFeatures;
+    for (const UBFeature &feature : pAddedFeatures) {
+        if (!known.contains(feature.getFullPath().toLocalFile())) {
+            addedFeatures << feature;
+        }
+    }
+
+    featuresModel->addItems(addedFeatures);
+
+    refreshModels();
 }
 
 void UBFeaturesController::createNpApiFeature(const QString &str)
@@ -834,20 +1029,10 @@ QImage UBFeaturesController::getIcon(const QString &path, UBFeatureElementType p
     } else if (pFType == FEATURE_VIDEO) {
         return QImage(":images/libpalette/movieIcon.svg");
     } else if (pFType == FEATURE_IMAGE) {
-        QFile file(path);
-        QImage pix;
-
-        if (file.open(QFile::ReadOnly))
-        {
-            QImageReader imageReader(&file);
-            imageReader.setAutoTransform(true);
-            pix = imageReader.read();
-        }
+        QImage pix = imageIcon(path);
 
         if (pix.isNull()) {
             pix = QImage(":images/libpalette/notFound.png");
-        } else {
-            pix = pix.scaledToWidth(qMin(UBSettings::maxThumbnailWidth, pix.width()));
         }
         return pix;
     }
@@ -855,6 +1040,68 @@ QImage UBFeaturesController::getIcon(const QString &path, UBFeatureElementType p
     return QImage(":images/libpalette/notFound.png");
 }
 
+QImage UBFeaturesController::imageIcon(const QString &path)
+{
+    QFileInfo fileInfo(path);
+    QString cacheFilePath = iconCacheFilePath(fileInfo);
+
+    QImage pix;
+
+    if (QFileInfo::exists(cacheFilePath) && pix.load(cacheFilePath, "PNG")) {
+        return pix;
+    }
+
+    QFile file(path);
+
+    if (file.open(QFile::ReadOnly))
+    {
+        QImageReader imageReader(&file);
+        imageReader.setAutoTransform(true);
+
+        // let the decoder downscale (JPEG, SVG, ...) instead of decoding the full picture
+        QSize size = imageReader.size();
+        bool scaled = size.isValid() && size.width() > UBSettings::maxThumbnailWidth;
+
+        if (scaled) {
+            imageReader.setScaledSize(size.scaled(UBSettings::maxThumbnailWidth, size.height(), Qt::KeepAspectRatio));
+        }
+
+        pix = imageReader.read();
+
+        if (!pix.isNull() && pix.width() > UBSettings::maxThumbnailWidth) {
+            pix = pix.scaledToWidth(UBSettings::maxThumbnailWidth, Qt::SmoothTransformation);
+            scaled = true;
+        }
+
+        // small pictures are cheaper to decode again than to cache
+        QDir cacheDir = QFileInfo(cacheFilePath).absoluteDir();
+
+        if (scaled && !pix.isNull() && cacheDir.mkpath(".")) {
+            // the directory of the file only holds the icons of its previous versions
+            foreach (QString staleEntry, cacheDir.entryList(QDir::Files)) {
+                cacheDir.remove(staleEntry);
+            }
+
+            QSaveFile cacheFile(cacheFilePath);
+            if (cacheFile.open(QIODevice::WriteOnly) && pix.save(&cacheFile, "PNG")) {
+                cacheFile.commit();
+            }
+        }
+    }
+
+    return pix;
+}
+
+QString UBFeaturesController::iconCacheFilePath(const QFileInfo &fileInfo)
+{
+    // one directory per path, the size and modification time name the icon, so a modified file simply misses
+    QByteArray pathHash = QCryptographicHash::hash(fileInfo.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+
+    return libraryIconCacheDirectory() + "/" + QString::fromLatin1(pathHash)
+            + "/" + QString::number(fileInfo.size())
+            + "-" + QString::number(fileInfo.lastModified().toMSecsSinceEpoch()) + ".png";
+}
+
 bool UBFeaturesController::isDeletable( const QUrl &url )
 {
     UBFeatureElementType type = fileTypeFromUrl(fileNameFromUrl(url));
@@ -884,9 +1131,8 @@ QImage UBFeaturesController::createThumbnail(const QString &path)
     } else if ( mimetype.contains("video")) {
         thumbnailPath = ":images/libpalette/movieIcon.svg";
     } else {
-        QImage pix(path);
+        QImage pix = imageIcon(path);
         if (!pix.isNull()) {
-            pix = pix.scaledToWidth(qMin(UBSettings::maxThumbnailWidth, pix.width()), Qt::SmoothTransformation);
             return pix;
 
         } else {
@@ -1115,8 +1361,10 @@ void UBFeaturesController::rescanModel()
 {
     featuresModel->removeRows(0, featuresList->count());
 
-    //Could implement infolder scanning for better perfomance
+    // changes made while OpenBoard is running are picked up by the file system watcher,
+    // a full rescan is only needed on explicit request
     scanFS();
+    startThread();
     refreshModels();
 }
 
@@ -46,6 +46,8 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QListView>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
 
 class UBFeaturesModel;
 class UBFeaturesItemDelegate;
@@ -63,14 +65,19 @@ class UBFeaturesComputingThread : public QThread
 public:
     explicit UBFeaturesComputingThread(QObject *parent = 0);
     virtual ~UBFeaturesComputingThread();
-        void compute(const QList<QPair<QUrl, UBFeature> > &pScanningData, QSet<QUrl> *pFavoritesSet);
+    int compute(const QList<QPair<QUrl, UBFeature> > &pScanningData, QSet<QUrl> *pFavoritesSet);
+    // lists a single directory, the files already known are neither decoded nor sent again
+    void computeDirectory(const QString &pPath, const QString &pVirtualPath, const QSet<QString> &pKnownFiles, QSet<QUrl> *pFavoritesSet);
 
 protected:
     void run();
 
 signals:
-    void sendFeature(UBFeature pFeature);
-    void featureSent();
+    // features are streamed in batches, tagged with the generation returned by compute()
+    void sendFeatures(const QList<UBFeature> &pFeatures, int pGeneration);
+    void directoryScanned(const QString &pPath, const QString &pVirtualPath);
+    // all the files of the directory and the features of the ones that were not known
+    void directoryUpdated(const QString &pPath, const QStringList &pFiles, const QList<UBFeature> &pAddedFeatures, int pGeneration);
     void scanStarted();
     void scanFinished();
     void maxFilesCountEvaluated(int max);
@@ -80,10 +87,17 @@ signals:
 public slots:
 
 private:
+    struct DirectoryJob
+    {
+        QString path;
+        QString virtualPath;
+        QSet<QString> knownFiles;
+    };
+
     void scanFS(const QUrl & currentPath, const QString & currVirtualPath, const QSet<QUrl> &pFavoriteSet);
+    void scanDirectory(const DirectoryJob &pJob, const QSet<QUrl> &pFavoriteSet);
     void scanAll(QList<QPair<QUrl, UBFeature> > pScanningData, const QSet<QUrl> &pFavoriteSet);
-    int featuresCount(const QUrl &pPath);
-    int featuresCountAll(QList<QPair<QUrl, UBFeature> > pScanningData);
+    void flushFeatures(bool pForce);
 
 private:
     QMutex mMutex;
@@ -92,6 +106,12 @@ private:
     QString mScanningVirtualPath;
     QList<QPair<QUrl, UBFeature> > mScanningData;
     QSet<QUrl> mFavoriteSet;
+    QList<UBFeature> mPendingFeatures;
+    QList<DirectoryJob> mDirectoryJobs;
+    QElapsedTimer mBatchTimer;
+    int mGeneration;
+    int mScanningGeneration;
+    bool mScanRequested;
     bool restart;
     bool abort;
 };
@@ -241,7 +261,6 @@ signals:
     void maxFilesCountEvaluated(int pLimit);
     void scanStarted();
     void scanFinished();
-    void featureAddedFromThread();
     void scanCategory(const QString &);
     void scanPath(const QString &);
 
@@ -249,6 +268,11 @@ private slots:
     void addNewFolder(QString name);
     void startThread();
     void createNpApiFeature(const QString &str);
+    void addFeaturesFromThread(const QList<UBFeature> &pFeatures, int pGeneration);
+    void watchDirectory(const QString &pPath, const QString &pVirtualPath);
+    void directoryChanged(const QString &pPath);
+    void updateChangedDirectories();
+    void directoryUpdatedFromThread(const QString &pPath, const QStringList &pFiles, const QList<UBFeature> &pAddedFeatures, int pGeneration);
 
 private:
 
@@ -266,6 +290,10 @@ private:
 private:
 
     static QImage createThumbnail(const QString &path);
+    static QImage imageIcon(const QString &path);
+    static QString iconCacheFilePath(const QFileInfo &fileInfo);
+    void updateDirectory(const QString &pPath);
+    QSet<QString> knownFiles(const QString &pPath, const QString &pVirtualPath) const;
     //void addImageToCurrentPage( const QString &path );
     void loadFavoriteList();
     void saveFavoriteList();
@@ -311,6 +339,12 @@ private:
     QSet<QUrl> *favoriteSet;
     QSet<QUrl> recentlyOpenDocuments;
 
+    int mScanGeneration;
+    QFileSystemWatcher *mFileSystemWatcher;
+    QHash<QString, QString> mWatchedDirectories;
+    QSet<QString> mChangedDirectories;
+    QTimer *mChangedDirectoriesTimer;
+
 public:
     UBFeature trashElement;
     UBFeature getDestinationFeatureForUrl( const QUrl &url );
@@ -46,6 +46,7 @@
 #include "UBIdleTimer.h"
 #include "UBApplicationController.h"
 #include "UBShortcutManager.h"
+#include "UBTrace.h"
 
 #include "board/UBBoardController.h"
 #include "board/UBDrawingController.h"
@@ -66,10 +67,15 @@
 #include "frameworks/UBCryptoUtils.h"
 #include "tools/UBToolsManager.h"
 
+#ifdef UB_BENCHMARK
+#include "benchmark/UBBenchmark.h"
+#endif
+
 #include "UBDisplayManager.h"
 #include "core/memcheck.h"
 
 QPointer<QUndoStack> UBApplication::undoStack;
+QPointer<QUndoGroup> UBApplication::undoGroup;
 
 UBDisplayManager* UBApplication::displayManager = nullptr;
 UBApplicationController* UBApplication::applicationController = 0;
@@ -125,8 +131,15 @@ UBApplication::UBApplication(const QString &id, int &argc, char **argv) : Single
 
     UBResources::resources();
 
+    if (!undoGroup)
+        undoGroup = new QUndoGroup(staticMemoryCleaner);
+
     if (!undoStack)
+    {
         undoStack = new QUndoStack(staticMemoryCleaner);
+        undoGroup->addStack(undoStack);
+        undoGroup->setActiveStack(undoStack);
+    }
 
     UBPlatformUtils::init();
 
@@ -305,6 +318,22 @@ int UBApplication::exec(const QString& pFileToImport)
 {
     QPixmapCache::setCacheLimit(1024 * 100);
 
+    QString tracePath;
+
+    foreach (const QString& argument, arguments())
+    {
+        if (argument == "--trace")
+            tracePath = UBTrace::defaultOutputPath();
+        else if (argument.startsWith("--trace="))
+            tracePath = argument.mid(QString("--trace=").length());
+    }
+
+    if (tracePath.isEmpty() && UBSettings::settings()->appTraceEnabled->get().toBool())
+        tracePath = UBTrace::defaultOutputPath();
+
+    if (!tracePath.isEmpty())
+        UBTrace::start(tracePath);
+
     displayManager = new UBDisplayManager(staticMemoryCleaner);
 
     if (UBSettings::settings()->appRunInWindow->get().toBool()) {
@@ -420,6 +449,20 @@ int UBApplication::exec(const QString& pFileToImport)
 
     onScreenCountChanged(displayManager->numScreens());
     connect(displayManager, SIGNAL(availableScreenCountChanged(int)), this, SLOT(onScreenCountChanged(int)));
+
+#ifdef UB_BENCHMARK
+    QString benchmarkResultPath = UBBenchmark::resultPathFromArguments(arguments());
+
+    if (!benchmarkResultPath.isEmpty())
+    {
+        // run once the event loop is started and quit with the benchmark status
+        QTimer::singleShot(0, this, [benchmarkResultPath]() {
+            UBBenchmark benchmark(benchmarkResultPath);
+            QApplication::exit(benchmark.run() ? 0 : 1);
+        });
+    }
+#endif
+
     return QApplication::exec();
 }
 
@@ -743,6 +786,8 @@ void UBApplication::cleanup()
     boardController = NULL;
     webController = NULL;
     documentController = NULL;
+
+    UBTrace::stop();
 }
 
 QString UBApplication::urlFromHtml(QString html)
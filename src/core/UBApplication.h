@@ -32,6 +32,7 @@
 
 #include <QtGui>
 #include <QUndoStack>
+#include <QUndoGroup>
 #include <QToolBar>
 #include <QMenu>
 
@@ -68,7 +69,9 @@ class UBApplication : public SingleApplication
 
         void cleanup();
 
+        // undo stack of the active page, undo and redo actions go through the group
         static QPointer<QUndoStack> undoStack;
+        static QPointer<QUndoGroup> undoGroup;
 
         static UBDisplayManager* displayManager;
         static UBApplicationController *applicationController;
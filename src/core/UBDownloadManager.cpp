@@ -33,6 +33,7 @@
 #include "gui/UBMainWindow.h"
 #include "board/UBBoardController.h"
 #include "board/UBBoardPaletteManager.h"
+#include "document/UBDocumentProxy.h"
 #include "frameworks/UBFileSystemUtils.h"
 
 #include "core/memcheck.h"
@@ -79,23 +80,64 @@ void UBAsyncLocalFileDownloader::run()
     if (mDesc.originalSrcUrl.isEmpty())
         mDesc.originalSrcUrl = mDesc.srcUrl;
 
-    QUuid uuid = QUuid::createUuid();
-    UBPersistenceManager::persistenceManager()->addFileToDocument(UBApplication::boardController->selectedDocument(), 
-        mDesc.srcUrl,
-        destDirectory,
-        uuid,
-        mTo,
-        NULL);
+    UBPersistenceManager* persistenceManager = UBPersistenceManager::persistenceManager();
+    std::shared_ptr<UBDocumentProxy> document = UBApplication::boardController->selectedDocument();
 
-    if (m_bAborting)
+    QString destination;
+    bool created = false;
+    bool copied = false;
+
+    if (document && QFileInfo::exists(mDesc.srcUrl))
     {
-        if (QFile::exists(mTo))
-            QFile::remove(mTo);
+        QUuid uuid = QUuid::createUuid();
+        destination = persistenceManager->documentFilePath(document, mDesc.srcUrl, destDirectory, uuid);
+
+        if (!QFile::exists(destination) && QDir().mkpath(QFileInfo(destination).absolutePath()))
+        {
+            created = true;
+            copied = persistenceManager->linkFileToDocument(mDesc.srcUrl, destination) || copyFile(mDesc.srcUrl, destination);
+        }
     }
-    else
+
+    // never leave a partial or cancelled copy in the document
+    if (created && (!copied || m_bAborting))
+        QFile::remove(destination);
+
+    mTo = copied && !m_bAborting ? destination : QString();
+
+    if (!m_bAborting)
         emit signal_asyncCopyFinished(mDesc.id, !mTo.isEmpty(), QUrl::fromLocalFile(mTo), QUrl::fromLocalFile(mDesc.originalSrcUrl), "", NULL, mDesc.pos, mDesc.size, mDesc.isBackground);
 }
 
+bool UBAsyncLocalFileDownloader::copyFile(const QString& pFrom, const QString& pTo)
+{
+    QFile source(pFrom);
+    QFile destination(pTo);
+
+    if (!source.open(QIODevice::ReadOnly) || !destination.open(QIODevice::WriteOnly))
+        return false;
+
+    const qint64 total = source.size();
+    qint64 copied = 0;
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+
+    while (!m_bAborting)
+    {
+        qint64 read = source.read(buffer.data(), buffer.size());
+
+        if (read < 0 || (read > 0 && destination.write(buffer.constData(), read) != read))
+            return false;
+
+        if (read == 0)
+            return true;
+
+        copied += read;
+        emit signal_asyncCopyProgress(mDesc.id, copied, total);
+    }
+
+    return false;
+}
+
 void UBAsyncLocalFileDownloader::abort()
 {
     m_bAborting = true;
@@ -182,6 +224,7 @@ void UBDownloadManager::init()
     mCrntDL.clear();
     mPendingDL.clear();
     mDownloads.clear();
+    mStagedDownloads.clear();
     mLastID = 1;
     mDLAvailability.clear();
     for(int i=0; i<SIMULTANEOUS_DOWNLOAD; i++)
@@ -293,7 +336,19 @@ void UBDownloadManager::onDownloadFinished(int id, bool pSuccess, QUrl sourceUrl
 
             } else if(desc.dest == sDownloadFileDesc::board) {
                 // The downloaded file is modal so we must put it on the board
-                emit addDownloadedFileToBoard(pSuccess, sourceUrl, contentUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+                QString stagedFile = mStagedDownloads.take(id);
+
+                if (!stagedFile.isEmpty() && sourceUrl.isLocalFile() && sourceUrl.toLocalFile() == stagedFile)
+                {
+                    addStagedDownloadToBoard(pSuccess, stagedFile, contentUrl, pContentTypeHeader, pPos, pSize, isBackground);
+                }
+                else
+                {
+                    if (!stagedFile.isEmpty())
+                        QFile::remove(stagedFile);
+
+                    emit addDownloadedFileToBoard(pSuccess, sourceUrl, contentUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+                }
             }
             else
             {
@@ -387,6 +442,7 @@ void UBDownloadManager::startFileDownload(sDownloadFileDesc desc)
     if (desc.srcUrl.startsWith("file://") || desc.srcUrl.startsWith("/"))
     {
         UBAsyncLocalFileDownloader * cpHelper = new UBAsyncLocalFileDownloader(desc, this);
+        connect(cpHelper, SIGNAL(signal_asyncCopyProgress(int,qint64,qint64)), this, SLOT(onDownloadProgress(int,qint64,qint64)));
         connect(cpHelper, SIGNAL(signal_asyncCopyFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl,QString, QByteArray, QPointF, QSize, bool)));
         QObject *res = dynamic_cast<QObject *>(cpHelper->download());
         if (!res)
@@ -397,6 +453,14 @@ void UBDownloadManager::startFileDownload(sDownloadFileDesc desc)
     else
     {    
         UBDownloadHttpFile* http = new UBDownloadHttpFile(desc.id, this);
+
+        // downloads for the board are written to disk as they arrive instead of being held in memory
+        if (desc.dest == sDownloadFileDesc::board)
+        {
+            mStagedDownloads[desc.id] = stagedDownloadPath(desc);
+            http->setDownloadFilePath(mStagedDownloads[desc.id]);
+        }
+
         connect(http, SIGNAL(downloadProgress(int, qint64,qint64)), this, SLOT(onDownloadProgress(int,qint64,qint64)));
         connect(http, SIGNAL(downloadFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)), this, SLOT(onDownloadFinished(int, bool, QUrl, QUrl, QString, QByteArray, QPointF, QSize, bool)));
     
@@ -407,6 +471,98 @@ void UBDownloadManager::startFileDownload(sDownloadFileDesc desc)
     } 
 }
 
+/**
+ * \brief Get the file a board download is written to while it is received
+ * @param desc as the given file description
+ * @return the path of a hidden file in the document folder, so that the final move is a simple rename
+ */
+QString UBDownloadManager::stagedDownloadPath(const sDownloadFileDesc& desc)
+{
+    std::shared_ptr<UBDocumentProxy> document = UBApplication::boardController->selectedDocument();
+
+    if (!document)
+        return QString();
+
+    QString suffix = QFileInfo(QUrl::fromEncoded(desc.srcUrl.toUtf8()).path()).suffix();
+
+    return document->persistencePath() + "/.download-" + QUuid::createUuid().toString() + (suffix.isEmpty() ? QString() : "." + suffix);
+}
+
+/**
+ * \brief Remove the file a board download is written to, e.g. when the download is cancelled
+ * @param id as the download ID
+ */
+void UBDownloadManager::removeStagedDownload(int id)
+{
+    QString stagedFile = mStagedDownloads.take(id);
+
+    if (!stagedFile.isEmpty())
+        QFile::remove(stagedFile);
+}
+
+/**
+ * \brief Add a download written to disk to the board
+ * Media are moved into the document, other content is read back as it needs to be decoded anyway.
+ */
+void UBDownloadManager::addStagedDownloadToBoard(bool pSuccess, const QString& pStagedFile, QUrl contentUrl, QString pContentTypeHeader, QPointF pPos, QSize pSize, bool isBackground)
+{
+    if (!pSuccess)
+    {
+        QFile::remove(pStagedFile);
+        emit addDownloadedFileToBoard(false, contentUrl, contentUrl, pContentTypeHeader, QByteArray(), pPos, pSize, isBackground);
+        return;
+    }
+
+    QString mimeType = pContentTypeHeader.section(';', 0, 0);
+    if (mimeType.isEmpty())
+        mimeType = UBFileSystemUtils::mimeTypeFromFileName(contentUrl.toString());
+
+    UBMimeType::Enum itemMimeType = UBFileSystemUtils::mimeTypeFromString(mimeType);
+
+    if (UBMimeType::Video == itemMimeType || UBMimeType::Audio == itemMimeType)
+    {
+        QString mediaFile = pStagedFile;
+
+        if (QFileInfo(mediaFile).suffix().isEmpty())
+        {
+            mediaFile += "." + UBFileSystemUtils::fileExtensionFromMimeType(mimeType);
+            QFile::rename(pStagedFile, mediaFile);
+        }
+
+        QString destFile;
+        bool moved = UBPersistenceManager::persistenceManager()->moveFileToDocument(UBApplication::boardController->selectedDocument(),
+            mediaFile,
+            UBMimeType::Video == itemMimeType ? UBPersistenceManager::videoDirectory : UBPersistenceManager::audioDirectory,
+            QUuid::createUuid(),
+            destFile);
+
+        QFile::remove(mediaFile);
+
+        emit addDownloadedFileToBoard(moved, moved ? QUrl::fromLocalFile(destFile) : contentUrl, contentUrl, pContentTypeHeader, QByteArray(), pPos, pSize, isBackground);
+    }
+    else if (UBMimeType::PDF == itemMimeType)
+    {
+        // the PDF is imported from the file, which is not needed anymore afterwards
+        emit addDownloadedFileToBoard(true, QUrl::fromLocalFile(pStagedFile), contentUrl, pContentTypeHeader, QByteArray(), pPos, pSize, isBackground);
+        QFile::remove(pStagedFile);
+    }
+    else
+    {
+        QByteArray data;
+        QFile file(pStagedFile);
+
+        if (file.open(QIODevice::ReadOnly))
+        {
+            data = file.readAll();
+            file.close();
+        }
+
+        file.remove();
+
+        emit addDownloadedFileToBoard(true, contentUrl, contentUrl, pContentTypeHeader, data, pPos, pSize, isBackground);
+    }
+}
+
 /**
  * \brief Verify if modal downloads remains and notify everyone if it is not the case.
  */
@@ -464,6 +620,10 @@ void UBDownloadManager::cancelDownloads()
         }
     }
 
+    // the aborted replies normally remove their file already
+    foreach (int id, mStagedDownloads.keys())
+        removeStagedDownload(id);
+
     // Clear all the lists
     init();
 
@@ -505,6 +665,7 @@ void UBDownloadManager::cancelDownload(int id)
     }
 
     mDownloads.remove(id);
+    removeStagedDownload(id);
 
     // Remove the canceled download from the download lists
     bool bFound = false;
@@ -592,6 +753,10 @@ void UBDownloadHttpFile::onDownloadProgress(qint64 bytesReceived, qint64 bytesTo
 void UBDownloadHttpFile::onDownloadFinished(bool pSuccess, QUrl sourceUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground)
 {
     // Notify the end of the download
-    emit downloadFinished(mId, pSuccess, sourceUrl, sourceUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+    if (!downloadFilePath().isEmpty())
+        // the content is in the download file, the remote url is reported as content url
+        emit downloadFinished(mId, pSuccess, QUrl::fromLocalFile(downloadFilePath()), sourceUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
+    else
+        emit downloadFinished(mId, pSuccess, sourceUrl, sourceUrl, pContentTypeHeader, pData, pPos, pSize, isBackground);
 }
 
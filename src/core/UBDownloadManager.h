@@ -36,6 +36,8 @@
 #include <QMutex>
 #include <QDropEvent>
 
+#include <atomic>
+
 #include "UBDownloadThread.h"
 
 #include "network/UBHttpGet.h"
@@ -113,12 +115,15 @@ public:
 
 signals:
     void finished(QString srcUrl, QString resUrl);
+    void signal_asyncCopyProgress(int id, qint64 copied, qint64 total);
     void signal_asyncCopyFinished(int id, bool pSuccess, QUrl sourceUrl, QUrl contentUrl, QString pContentTypeHeader, QByteArray pData, QPointF pPos, QSize pSize, bool isBackground);
 
 
 private:
+    bool copyFile(const QString& pFrom, const QString& pTo);
+
     sDownloadFileDesc mDesc;
-    bool m_bAborting;
+    std::atomic<bool> m_bAborting;
     QString mFrom;
     QString mTo;
 };
@@ -160,6 +165,9 @@ private:
     void updateDownloadOrder();
     void updateFileCurrentSize(int id, qint64 received=-1, qint64 total=-1);
     void startFileDownload(sDownloadFileDesc desc);
+    QString stagedDownloadPath(const sDownloadFileDesc& desc);
+    void addStagedDownloadToBoard(bool pSuccess, const QString& pStagedFile, QUrl contentUrl, QString pContentTypeHeader, QPointF pPos, QSize pSize, bool isBackground);
+    void removeStagedDownload(int id);
     void checkIfModalRemains();
     void finishDownloads(bool cancel=false);
 
@@ -175,6 +183,8 @@ private:
     QVector<int> mDLAvailability;
     /** A map containing the replies of the GET operations */
     QMap<int, QObject*> mDownloads;
+    /** A map containing the files the board downloads are written to */
+    QMap<int, QString> mStagedDownloads;
 };
 
 #endif // UBDOWNLOADMANAGER_H
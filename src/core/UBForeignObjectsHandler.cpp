@@ -28,7 +28,10 @@
 
 #include <QtGui>
 #include <QtXml>
+#include <QtConcurrent>
 #include "UBSettings.h"
+#include "frameworks/UBPlatformUtils.h"
+#include "adaptors/UBSvgSubsetAdaptor.h"
 
 const QString tVideo = "video";
 const QString tAudio = "audio";
@@ -53,6 +56,7 @@ const QString wgtSuff = ".wgt";
 const QString thumbSuff = ".png";
 
 const QString scanDirs = "audios,images,videos,teacherGuideObjects,widgets";
+const QString videosDir = "videos";
 const QStringList trashFilter = QStringList() << "*.swf";
 
 
@@ -155,6 +159,13 @@ static QString thumbFileNameFrom(const QString &filePath)
     return thumbPath;
 }
 
+// video items keep a poster frame next to the video, with the same base name
+static QString posterFileNameFrom(const QString &filePath)
+{
+    QFileInfo fileInfo(filePath);
+    return fileInfo.path() + "/" + fileInfo.completeBaseName() + thumbSuff;
+}
+
 
 QString svgPageName(int pageIndex)
 {
@@ -222,6 +233,12 @@ public:
                 if (QFile::exists(thumbPath)) {
                     rm_r(thumbPath);
                 }
+            } else if (QFileInfo(delPath).dir().dirName() == videosDir) { //remove corresponding poster
+                QString posterPath = posterFileNameFrom(delPath);
+
+                if (QFile::exists(posterPath)) {
+                    rm_r(posterPath);
+                }
             }
             rm_r(delPath);
             // Clear parent dir if empty
@@ -278,8 +295,15 @@ private:
 
     void fitIdsFromDir(const QString &scanDir)
     {
+        bool isVideosDir = QDir(scanDir).dirName() == videosDir;
+
         QFileInfoList fileList = QDir(scanDir).entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
         foreach (QFileInfo nInfo, fileList) {
+            // posters share the uuid of their video, they are removed with it
+            if (isVideosDir && nInfo.fileName().endsWith(thumbSuff)) {
+                continue;
+            }
+
             QString uid = strIdFrom(nInfo.fileName());
             if (uid.isNull()) {
                 continue;
@@ -481,116 +505,172 @@ private:
 class PageCopier
 {
 public:
-    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+    /**
+     * Stream the page into its copy, giving new uuids to its items and to the assets they reference.
+     * The page is never parsed into a tree nor loaded into a scene. The assets are copied in the
+     * background, assetCopy finishes when they are all in place. On failure no copy is left behind.
+     */
+    bool copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, QFuture<void> &assetCopy)
     {
         mFromDir = fromDir.toLocalFile();
         mToDir = toDir.toLocalFile();
-        mFromIndex = fromIndex;
-        mToIndex = toIndex;
-
-        QString svgFrom = mFromDir + "/" + svgPageName(fromIndex);
-        QString svgTo = toDir.toLocalFile() + "/" + svgPageName(toIndex);
-        QDomDocument dd = createDomFromSvg(svgFrom);
-        QFile fl(svgTo);
-        if (!fl.open(QIODevice::WriteOnly)) {
-            qDebug() << Q_FUNC_INFO << "can't open" << fl.fileName() << "for writing";
-            return;
+
+        // pages written by older versions may contain NUL characters, cleaned as when loading them
+        QFile source(mFromDir + "/" + svgPageName(fromIndex));
+        const QByteArray data = UBSvgSubsetAdaptor::readSceneData(source, true);
+        if (data.isEmpty()) {
+            qWarning() << Q_FUNC_INFO << "can't read" << source.fileName();
+            return false;
         }
-        cureIdsFromSvgDom(dd);
 
-        QTextStream str(&fl);
-        dd.save(str, 0);
-        fl.close();
-        qDebug() << Q_FUNC_INFO;
-    }
+        QFile target(mToDir + "/" + svgPageName(toIndex));
+        if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << Q_FUNC_INFO << "can't open" << target.fileName() << "for writing";
+            return false;
+        }
 
-private:
-    void cureIdsFromSvgDom(const QDomDocument &dom)
-    {
-        Q_ASSERT(!dom.isNull());
+        QXmlStreamReader reader(data);
+        QXmlStreamWriter writer(&target);
 
-        QDomElement nextElement = dom.documentElement().firstChildElement();
-        while (!nextElement.isNull( )) {
-            qDebug() << "Tag name of the next parsed element is" << nextElement.tagName();
-            QString nextTag = nextElement.tagName();
-            cureFromText(nextTag, nextElement);
-            nextElement = nextElement.nextSiblingElement();
+        while (!reader.atEnd()) {
+            reader.readNext();
+
+            if (reader.hasError()) {
+                break;
+            }
+
+            if (reader.isStartElement()) {
+                copyStartElement(reader, writer);
+            } else {
+                writer.writeCurrentToken(reader);
+            }
+        }
+
+        target.close();
+
+        if (reader.hasError() || writer.hasError() || target.error() != QFile::NoError) {
+            qWarning() << Q_FUNC_INFO << "can't copy" << source.fileName() << "at line" << reader.lineNumber() << ":" << reader.errorString();
+            target.remove();
+            return false;
         }
+
+        QList<QPair<QString, QString> > assets = mAssets;
+        assetCopy = QtConcurrent::run([assets]() {
+            for (const QPair<QString, QString> &asset : assets) {
+                copyAsset(asset.first, asset.second);
+            }
+        });
+
+        return true;
     }
 
-    void cureFromText(const QString &tagName, QDomElement element)
+private:
+    void copyStartElement(const QXmlStreamReader &reader, QXmlStreamWriter &writer)
     {
-        if (tagName == tVideo
-                || tagName == tAudio
-                || tagName == tImage) {
-            QString newRelative = cureNCopy(element.attribute(aHref));
-            element.setAttribute(aHref, newRelative);
-            if (element.hasAttribute(aActionMedia)) {
-                QString newActionPath = cureNCopy(element.attribute(aActionMedia));
-                element.setAttribute(aActionMedia, newActionPath);
+        QString tagName = reader.name().toString();
+        QXmlStreamAttributes attributes = reader.attributes();
+
+        // declared before the element, so that it is written with the original prefixes
+        const QXmlStreamNamespaceDeclarations namespaces = reader.namespaceDeclarations();
+        for (const QXmlStreamNamespaceDeclaration &ns : namespaces) {
+            if (ns.prefix().isEmpty()) {
+                writer.writeDefaultNamespace(ns.namespaceUri().toString());
+            } else {
+                writer.writeNamespace(ns.namespaceUri().toString(), ns.prefix().toString());
             }
-        } else if (tagName == tForeignObject) {
-            //Pdf object is a special case. Detect if it ends with #reference
-            QString reqExt = element.attribute(aReqExt);
-            if (reqExt == vReqExt) { //pdf reference
-                QString ref = element.attribute(aHref);
-                int i = ref.indexOf("#page");
-                QString dest = ref.replace(i, ref.length()-i, "");
-                if (!QFileInfo::exists(dest))
-                    cureNCopy(dest, false);
-                if (ref.isEmpty()) {
-                    return;
+        }
+
+        writer.writeStartElement(reader.namespaceUri().toString(), tagName);
+
+        //Pdf object is a special case: the file is shared by all the pages of the document
+        bool isPdf = tagName == tForeignObject && attributes.value(aReqExt) == vReqExt;
+        bool isText = tagName == tForeignObject && attributes.value(aType) == vText;
+
+        for (const QXmlStreamAttribute &attribute : attributes) {
+            QString name = attribute.name().toString();
+            QString value = attribute.value().toString();
+            QString newValue = value;
+
+            if (isPdf && name == "href") {
+                QString pdfPath = value.left(value.indexOf("#page"));
+                if (!QFileInfo::exists(mToDir + "/" + pdfPath)) {
+                    addAsset(pdfPath, pdfPath);
                 }
-                static const QRegularExpression pdfReference("^(.*pdf\\#page\\=).*$");
-                ref.replace(pdfReference, QString("\\1%1").arg(mToIndex));
-                return;
+            } else if (name != "source") {
+                newValue = remapUuids(value);
             }
 
-            QString type = element.attribute(aType);
-            if (type == vText) { // We don't have to care of the text object
-                if (element.hasAttribute(aActionMedia)) {
-                    QString newRelative = cureNCopy(element.attribute(aActionMedia));
-                    element.setAttribute(aActionMedia, newRelative);
+            if (((tagName == tVideo || tagName == tAudio || tagName == tImage) && name == "href")
+                    || (tagName == tMedia && name == aRelativePath)
+                    || (name == "actionFirstParameter" && QFileInfo(mFromDir + "/" + value).isFile())) {
+                addAsset(value, newValue);
+
+                if (tagName == tVideo && QFileInfo::exists(mFromDir + "/" + posterFileNameFrom(value))) {
+                    addAsset(posterFileNameFrom(value), posterFileNameFrom(newValue));
                 }
-                return;
-            }
-            QString newRelative = cureNCopy(element.attribute(aSrc));
-            element.setAttribute(aSrc, newRelative);
-        } else if (tagName == tTeacherGuide) {
-            QDomElement nMediaElement = element.firstChildElement(tMedia);
-            while (!nMediaElement.isNull()) {
-                QString newRelative = cureNCopy(nMediaElement.attribute(aRelativePath));
-                nMediaElement.setAttribute(aRelativePath, newRelative);
-                nMediaElement = nMediaElement.nextSiblingElement(tMedia);
+            } else if (tagName == tForeignObject && !isPdf && !isText && name == "src") {
+                addAsset(value, newValue);
+                addAsset(thumbFileNameFrom(value), thumbFileNameFrom(newValue));
             }
+
+            writer.writeAttribute(attribute.namespaceUri().toString(), name, newValue);
         }
     }
 
-    QString cureNCopy(const QString &relativePath, bool createNewUuid=true)
+    QString remapUuids(const QString &value)
     {
-        QString relative = relativePath;
-        if (createNewUuid)
-        {
-            QUuid newUuid = QUuid::createUuid();
-            static const QRegularExpression bracedUuid("\\{.*\\}");
-            QString newPath = relative.replace(bracedUuid, newUuid.toString());
+        static const QRegularExpression uuid("[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}");
+
+        QRegularExpressionMatchIterator matches = uuid.globalMatch(value);
+        if (!matches.hasNext()) {
+            return value;
+        }
+
+        // the same uuid always gets the same replacement, so references between elements stay valid
+        QString result;
+        int last = 0;
+
+        while (matches.hasNext()) {
+            QRegularExpressionMatch match = matches.next();
+            QString oldUuid = match.captured().toLower();
+
+            if (!mUuids.contains(oldUuid)) {
+                mUuids.insert(oldUuid, QUuid::createUuid().toString(QUuid::WithoutBraces));
+            }
+
+            result += value.mid(last, match.capturedStart() - last) + mUuids.value(oldUuid);
+            last = match.capturedEnd();
+        }
 
-            cp_rf(mFromDir + "/" + relativePath, mToDir + "/" + newPath);
+        return result + value.mid(last);
+    }
 
-            return newPath;
+    void addAsset(const QString &relativePath, const QString &newRelativePath)
+    {
+        if (relativePath.isEmpty() || (mFromDir == mToDir && relativePath == newRelativePath)) {
+            return;
         }
-        else
-        {
-            cp_rf(mFromDir + "/" + relativePath, mToDir + "/" + relativePath);
-            return relativePath;
+
+        mAssets << qMakePair(mFromDir + "/" + relativePath, mToDir + "/" + newRelativePath);
+    }
+
+    static void copyAsset(const QString &what, const QString &where)
+    {
+        // some assets (e.g. widget snapshots) are rewritten in place, so the copy must never be
+        // a hard link to the original. A copy-on-write clone is still fine.
+        if (QFileInfo(what).isFile() && QDir().mkpath(QFileInfo(where).absolutePath())
+                && UBPlatformUtils::linkFile(what, where, false)) {
+            return;
         }
+
+        cp_rf(what, where);
     }
 
 private:
     QString mFromDir;
     QString mToDir;
-    int mFromIndex;
-    int mToIndex;
+    QHash<QString, QString> mUuids;
+    QList<QPair<QString, QString> > mAssets;
 };
 
 class UBForeighnObjectsHandlerPrivate {
@@ -608,12 +688,10 @@ public:
         cleaner = 0;
     }
 
-    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+    bool copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, QFuture<void> &assetCopy)
     {
-        PageCopier *copier = new PageCopier;
-        copier->copyPage(fromDir, fromIndex, toDir, toIndex);
-        delete copier;
-        copier = 0;
+        PageCopier copier;
+        return copier.copyPage(fromDir, fromIndex, toDir, toIndex, assetCopy);
     }
 
 private:
@@ -644,8 +722,8 @@ void UBForeighnObjectsHandler::cure(const QUrl &dir)
     d->cure(dir);
 }
 
-void UBForeighnObjectsHandler::copyPage(const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+bool UBForeighnObjectsHandler::copyPage(const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, QFuture<void> &assetCopy)
 {
-    d->copyPage(fromDir, fromIndex, toDir, toIndex);
+    return d->copyPage(fromDir, fromIndex, toDir, toIndex, assetCopy);
 }
 
@@ -29,6 +29,7 @@
 
 #include <QList>
 #include <QUrl>
+#include <QFuture>
 #include <algorithm>
 
 class UBForeighnObjectsHandlerPrivate;
@@ -42,8 +43,8 @@ public:
     void cure(const QList<QUrl> &dirs);
     void cure(const QUrl &dir);
 
-    void copyPage(const QUrl &fromDir, int fromIndex,
-                  const QUrl &toDir, int toIndex);
+    bool copyPage(const QUrl &fromDir, int fromIndex,
+                  const QUrl &toDir, int toIndex, QFuture<void> &assetCopy);
 
 private:
     UBForeighnObjectsHandlerPrivate *d;
@@ -69,3 +69,47 @@ UBMimeDataGraphicsItem::~UBMimeDataGraphicsItem()
 {
 // Explanation: selected items are owned by the scene and handled by this class
 }
+
+static const QString sImageMimeType("application/x-qt-image");
+
+UBMimeDataImage::UBMimeDataImage(std::function<QImage()> imageSource)
+    : QMimeData()
+    , mImageSource(imageSource)
+{
+    // NOOP
+}
+
+UBMimeDataImage::~UBMimeDataImage()
+{
+    // NOOP
+}
+
+bool UBMimeDataImage::hasFormat(const QString& mimeType) const
+{
+    return mimeType == sImageMimeType || QMimeData::hasFormat(mimeType);
+}
+
+QStringList UBMimeDataImage::formats() const
+{
+    QStringList formats = QMimeData::formats();
+
+    if (!formats.contains(sImageMimeType))
+        formats << sImageMimeType;
+
+    return formats;
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+QVariant UBMimeDataImage::retrieveData(const QString& mimeType, QMetaType type) const
+#else
+QVariant UBMimeDataImage::retrieveData(const QString& mimeType, QVariant::Type type) const
+#endif
+{
+    if (mimeType != sImageMimeType)
+        return QMimeData::retrieveData(mimeType, type);
+
+    if (mImage.isNull() && mImageSource)
+        mImage = mImageSource();
+
+    return mImage;
+}
@@ -32,6 +32,8 @@
 
 #include <QtGui>
 
+#include <functional>
+
 class UBDocumentProxy;
 class UBItem;
 
@@ -82,4 +84,31 @@ class UBMimeData : public QMimeData
         QList<UBMimeDataItem> mItems;
 };
 
+
+/**
+ * Image dragged out of the board. The image is only produced when a drop target asks for it.
+ */
+class UBMimeDataImage : public QMimeData
+{
+    Q_OBJECT;
+
+    public:
+        UBMimeDataImage(std::function<QImage()> imageSource);
+        virtual ~UBMimeDataImage();
+
+        virtual bool hasFormat(const QString& mimeType) const;
+        virtual QStringList formats() const;
+
+    protected:
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        virtual QVariant retrieveData(const QString& mimeType, QMetaType type) const;
+#else
+        virtual QVariant retrieveData(const QString& mimeType, QVariant::Type type) const;
+#endif
+
+    private:
+        std::function<QImage()> mImageSource;
+        mutable QImage mImage;
+};
+
 #endif /* UBMIMEDATA_H_ */
@@ -43,6 +43,7 @@
 #include "core/UBSettings.h"
 #include "core/UBSetting.h"
 #include "core/UBForeignObjectsHandler.h"
+#include "core/UBTrace.h"
 
 #include "document/UBDocumentProxy.h"
 
@@ -116,6 +117,8 @@ UBPersistenceManager::UBPersistenceManager(QObject *pParent)
     connect(mWorker, &UBPersistenceWorker::scenePersisted, this, &UBPersistenceManager::onScenePersisted);
 
     mThread->start();
+
+    UBTrace::registerCounter("persistence.scenes_to_save", [this]() { return qint64(mScenesToSave.size()); });
 }
 
 UBPersistenceManager* UBPersistenceManager::persistenceManager()
@@ -148,6 +151,8 @@ void UBPersistenceManager::onScenePersisted(UBGraphicsScene *scene)
 
 UBPersistenceManager::~UBPersistenceManager()
 {
+    UBTrace::unregisterCounter("persistence.scenes_to_save");
+
     mIsApplicationClosing = true;
 
     if(mWorker)
@@ -449,6 +454,8 @@ QString UBPersistenceManager::adjustDocumentVirtualPath(const QString &str)
 
 void UBPersistenceManager::closing()
 {
+    waitForAssetCopies();
+
     QDir rootDir(mDocumentRepositoryPath);
     rootDir.mkpath(rootDir.path());
 
@@ -474,6 +481,11 @@ bool UBPersistenceManager::isSceneInCached(std::shared_ptr<UBDocumentProxy> prox
     return mSceneCache.contains(proxy, index);
 }
 
+bool UBPersistenceManager::isSceneInCached(std::shared_ptr<UBGraphicsScene> scene) const
+{
+    return mSceneCache.containsScene(scene);
+}
+
 QStringList UBPersistenceManager::allShapes()
 {
     QString shapeLibraryPath = UBSettings::settings()->applicationShapeLibraryDirectory();
@@ -721,6 +733,7 @@ void UBPersistenceManager::deleteDocument(std::shared_ptr<UBDocumentProxy> pDocu
 {
     qWarning() << "deleting dir with path: " << pDocumentProxy->persistencePath();
     checkIfDocumentRepositoryExists();
+    waitForAssetCopies();
 
     if (QFileInfo(pDocumentProxy->persistencePath()).exists())
         UBFileSystemUtils::deleteDir(pDocumentProxy->persistencePath());
@@ -731,6 +744,7 @@ void UBPersistenceManager::deleteDocument(std::shared_ptr<UBDocumentProxy> pDocu
 std::shared_ptr<UBDocumentProxy> UBPersistenceManager::duplicateDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
 {
     checkIfDocumentRepositoryExists();
+    waitForAssetCopies();
 
     std::shared_ptr<UBDocumentProxy> copy = std::make_shared<UBDocumentProxy>();
 
@@ -768,6 +782,7 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::duplicateDocument(std::sh
 void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy> proxy, const QList<int>& indexes)
 {
     checkIfDocumentRepositoryExists();
+    waitForAssetCopies();
 
     int pageCount = UBPersistenceManager::persistenceManager()->sceneCount(proxy);
 
@@ -854,7 +869,7 @@ void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy>
 }
 
 
-void UBPersistenceManager::duplicateDocumentScene(std::shared_ptr<UBDocumentProxy> proxy, int index)
+bool UBPersistenceManager::duplicateDocumentScene(std::shared_ptr<UBDocumentProxy> proxy, int index)
 {
     checkIfDocumentRepositoryExists();
 
@@ -868,98 +883,32 @@ void UBPersistenceManager::duplicateDocumentScene(std::shared_ptr<UBDocumentProx
 
     }
 
-    copyPage(proxy, index , index + 1);
-
-    //TODO: write a proper way to handle object on disk
-    std::shared_ptr<UBGraphicsScene> scene = loadDocumentScene(proxy, index + 1);
-
-    foreach(QGraphicsItem* item, scene->items())
+    if (!copyPage(proxy, index , index + 1))
     {
-        UBGraphicsMediaItem *mediaItem = qgraphicsitem_cast<UBGraphicsMediaItem*> (item);
-
-        if (mediaItem){
-            QString source = mediaItem->mediaFileUrl().toLocalFile();
-            QString destination = source;
-            QUuid newUuid = QUuid::createUuid();
-            QString fileName = QFileInfo(source).completeBaseName();
-            destination = destination.replace(fileName,newUuid.toString());
-            QFile::copy(source,destination);
-            mediaItem->setMediaFileUrl(QUrl::fromLocalFile(destination));
-            continue;
-        }
-
-        UBGraphicsWidgetItem* widget = qgraphicsitem_cast<UBGraphicsWidgetItem*>(item);
-        if(widget){
-            QUuid newUUid = QUuid::createUuid();
-            QString newUUidString = newUUid.toString().remove("{").remove("}");
-            QString actualUuidString = widget->uuid().toString().remove("{").remove("}");
-
-            QString widgetSourcePath = proxy->persistencePath() + "/" + UBPersistenceManager::widgetDirectory + "/{" + actualUuidString + "}.wgt";
-            QString screenshotSourcePath = proxy->persistencePath() + "/" +  UBPersistenceManager::widgetDirectory + "/" + actualUuidString + ".png";
-
-            QString widgetDestinationPath = widgetSourcePath;
-            widgetDestinationPath = widgetDestinationPath.replace(actualUuidString,newUUidString);
-            QString screenshotDestinationPath = screenshotSourcePath;
-            screenshotDestinationPath = screenshotDestinationPath.replace(actualUuidString,newUUidString);
-
-            UBFileSystemUtils::copyDir(widgetSourcePath,widgetDestinationPath);
-            QFile::copy(screenshotSourcePath,screenshotDestinationPath);
-
-            widget->setUuid(newUUid);
-
-            widget->widgetUrl(QUrl::fromLocalFile(widgetDestinationPath));
-
-            continue;
-        }
-
-        UBGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<UBGraphicsPixmapItem*>(item);
-        if(pixmapItem){
-            QDir imageDir = proxy->persistencePath() + "/" + UBPersistenceManager::imageDirectory;
-            QStringList imageFiles = imageDir.entryList({pixmapItem->uuid().toString() + ".*"});
-
-            if (!imageFiles.isEmpty())
-            {
-                QString source = proxy->persistencePath() + "/" +  UBPersistenceManager::imageDirectory + "/" + imageFiles.last();
-                QString destination = source;
-                QUuid newUuid = QUuid::createUuid();
-                QString fileName = QFileInfo(source).completeBaseName();
-                destination = destination.replace(fileName,newUuid.toString());
-                QFile::copy(source,destination);
-                pixmapItem->setUuid(newUuid);
-            }
-
-            continue;
-        }
-
-        UBGraphicsSvgItem* svgItem = qgraphicsitem_cast<UBGraphicsSvgItem*>(item);
-        if(svgItem){
-            QString source = proxy->persistencePath() + "/" +  UBPersistenceManager::imageDirectory + "/" + svgItem->uuid().toString() + ".svg";
-            QString destination = source;
-            QUuid newUuid = QUuid::createUuid();
-            QString fileName = QFileInfo(source).completeBaseName();
-            destination = destination.replace(fileName,newUuid.toString());
-            QFile::copy(source,destination);
-            svgItem->setUuid(newUuid);
-            continue;
+        // put the following pages back in place
+        for (int i = index + 2; i <= pageCount; i++)
+        {
+            renamePage(proxy, i, i - 1);
+            mSceneCache.moveScene(proxy, i, i - 1);
         }
 
+        return false;
     }
-    scene->setModified(true);
 
     proxy->incPageCount();
 
-    persistDocumentScene(proxy,scene, index + 1);
-
     persistDocumentMetadata(proxy);
 
     emit documentSceneCreated(proxy, index + 1);
+
+    return true;
 }
 
-void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> from, int fromIndex, std::shared_ptr<UBDocumentProxy> to, int toIndex)
+bool UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> from, int fromIndex, std::shared_ptr<UBDocumentProxy> to, int toIndex)
 {
     if (from == to && toIndex <= fromIndex) {
         qDebug() << "operation is not supported" << Q_FUNC_INFO;
-        return;
+        return false;
     }
 
     checkIfDocumentRepositoryExists();
@@ -970,8 +919,20 @@ void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> fr
     }
 
     UBForeighnObjectsHandler hl;
-    hl.copyPage(QUrl::fromLocalFile(from->persistencePath()), fromIndex,
-                QUrl::fromLocalFile(to->persistencePath()), toIndex);
+    QFuture<void> assetCopy;
+
+    if (!hl.copyPage(QUrl::fromLocalFile(from->persistencePath()), fromIndex,
+                     QUrl::fromLocalFile(to->persistencePath()), toIndex, assetCopy)) {
+        // put the following pages back in place
+        for (int i = toIndex + 1; i <= to->pageCount(); i++) {
+            renamePage(to, i, i - 1);
+            mSceneCache.moveScene(to, i, i - 1);
+        }
+
+        return false;
+    }
+
+    trackAssetCopy(assetCopy);
 
     to->incPageCount();
 
@@ -989,10 +950,12 @@ void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> fr
     ctrl->TreeViewSelectionChanged(ctrl->firstSelectedTreeIndex(), QModelIndex());
 
 //    emit documentSceneCreated(to, toIndex + 1);
+
+    return true;
 }
 
 
-std::shared_ptr<UBGraphicsScene> UBPersistenceManager::createDocumentSceneAt(std::shared_ptr<UBDocumentProxy> proxy, int index, bool useUndoRedoStack)
+std::shared_ptr<UBGraphicsScene> UBPersistenceManager::createDocumentSceneAt(std::shared_ptr<UBDocumentProxy> proxy, int index, bool useUndoRedoStack, bool persist)
 {
     int count = proxy->pageCount();
 
@@ -1012,7 +975,9 @@ std::shared_ptr<UBGraphicsScene> UBPersistenceManager::createDocumentSceneAt(std
 
     proxy->incPageCount();
 
-    persistDocumentScene(proxy, newScene, index);
+    if (persist) {
+        persistDocumentScene(proxy, newScene, index);
+    }
 
     emit documentSceneCreated(proxy, index);
 
@@ -1087,6 +1052,8 @@ void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pro
 
 std::shared_ptr<UBGraphicsScene> UBPersistenceManager::loadDocumentScene(std::shared_ptr<UBDocumentProxy> proxy, int sceneIndex, bool cacheNeighboringScenes)
 {
+    waitForAssetCopies();
+
     mSceneCache.prepareLoading(proxy, sceneIndex);
     auto scene = mSceneCache.value(proxy, sceneIndex);
     qDebug() << "loadDocumentScene: got result from cache";
@@ -1178,17 +1145,46 @@ void UBPersistenceManager::renamePage(std::shared_ptr<UBDocumentProxy> pDocument
 }
 
 
-void UBPersistenceManager::copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
+bool UBPersistenceManager::copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
 {
-    QFile svg(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",sourceIndex));
-    svg.copy(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", targetIndex));
+    // the page is rewritten with new uuids for the scene, its items and their files
+    QUrl documentUrl = QUrl::fromLocalFile(pDocumentProxy->persistencePath());
+
+    UBForeighnObjectsHandler handler;
+    QFuture<void> assetCopy;
 
-    UBSvgSubsetAdaptor::setSceneUuid(pDocumentProxy, targetIndex, QUuid::createUuid());
+    if (!handler.copyPage(documentUrl, sourceIndex, documentUrl, targetIndex, assetCopy))
+        return false;
+
+    trackAssetCopy(assetCopy);
 
     QFile thumb(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceIndex));
     thumb.copy(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetIndex));
+
+    return true;
+}
+
+
+void UBPersistenceManager::trackAssetCopy(const QFuture<void>& assetCopy)
+{
+    QMutableListIterator<QFuture<void>> it(mAssetCopies);
+
+    while (it.hasNext())
+    {
+        if (it.next().isFinished())
+            it.remove();
+    }
+
+    mAssetCopies << assetCopy;
 }
 
+void UBPersistenceManager::waitForAssetCopies()
+{
+    for (QFuture<void>& assetCopy : mAssetCopies)
+        assetCopy.waitForFinished();
+
+    mAssetCopies.clear();
+}
 
 int UBPersistenceManager::sceneCount(const std::shared_ptr<UBDocumentProxy> proxy)
 {
@@ -1333,9 +1329,7 @@ bool UBPersistenceManager::addFileToDocument(std::shared_ptr<UBDocumentProxy> pD
 
     qDebug() << fi.suffix();
 
-    QString fileName = subdir + "/" + objectUuid.toString() + "." + fi.suffix();
-
-    destinationPath = pDocumentProxy->persistencePath() + "/" + fileName;
+    destinationPath = documentFilePath(pDocumentProxy, path, subdir, objectUuid);
 
     if (!QFile::exists(destinationPath))
     {
@@ -1346,6 +1340,9 @@ bool UBPersistenceManager::addFileToDocument(std::shared_ptr<UBDocumentProxy> pD
 
         if (data == NULL)
         {
+            if (linkFileToDocument(path, destinationPath))
+                return true;
+
             QFile source(path);
             return source.copy(destinationPath);
         }
@@ -1372,6 +1369,49 @@ bool UBPersistenceManager::addFileToDocument(std::shared_ptr<UBDocumentProxy> pD
     }
 }
 
+bool UBPersistenceManager::moveFileToDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
+                                              QString path,
+                                              const QString& subdir,
+                                              QUuid objectUuid,
+                                              QString& destinationPath)
+{
+    if (!pDocumentProxy || objectUuid.isNull() || !QFileInfo::exists(path))
+        return false;
+
+    destinationPath = documentFilePath(pDocumentProxy, path, subdir, objectUuid);
+
+    if (QFile::exists(destinationPath))
+        return false;
+
+    QDir dir;
+    if (!dir.mkpath(pDocumentProxy->persistencePath() + "/" + subdir))
+        return false;
+
+    // a rename is free when the file is already on the same file system, e.g. a download staged in the document
+    if (QFile::rename(path, destinationPath))
+        return true;
+
+    // the source is removed afterwards, so it may share its data with the destination
+    if (!linkFileToDocument(path, destinationPath, true) && !QFile::copy(path, destinationPath))
+        return false;
+
+    QFile::remove(path);
+    return true;
+}
+
+QString UBPersistenceManager::documentFilePath(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QString& path, const QString& subdir, QUuid objectUuid) const
+{
+    return pDocumentProxy->persistencePath() + "/" + subdir + "/" + objectUuid.toString() + "." + QFileInfo(path).suffix();
+}
+
+bool UBPersistenceManager::linkFileToDocument(const QString& sourcePath, const QString& destinationPath, bool temporarySource) const
+{
+    // a hard link would let a later change of either file show in the other one, so it is only
+    // used for a temporary file of our own that is removed once linked. Other files are only
+    // cloned copy-on-write.
+    return UBPlatformUtils::linkFile(sourcePath, destinationPath, temporarySource);
+}
+
 bool UBPersistenceManager::addGraphicsWidgetToDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
                                                        QString path,
                                                        QUuid objectUuid,
@@ -100,13 +100,13 @@ class UBPersistenceManager : public QObject
 
         virtual void deleteDocumentScenes(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QList<int>& indexes);
 
-        virtual void duplicateDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int index);
+        virtual bool duplicateDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int index);
 
-        virtual void copyDocumentScene(std::shared_ptr<UBDocumentProxy>from, int fromIndex, std::shared_ptr<UBDocumentProxy>to, int toIndex);
+        virtual bool copyDocumentScene(std::shared_ptr<UBDocumentProxy>from, int fromIndex, std::shared_ptr<UBDocumentProxy>to, int toIndex);
 
         virtual void persistDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, std::shared_ptr<UBGraphicsScene> pScene, const int pSceneIndex, bool isAnAutomaticBackup = false, bool forceImmediateSaving = false);
 
-        virtual std::shared_ptr<UBGraphicsScene> createDocumentSceneAt(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int index, bool useUndoRedoStack = true);
+        virtual std::shared_ptr<UBGraphicsScene> createDocumentSceneAt(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int index, bool useUndoRedoStack = true, bool persist = true);
 
         virtual void insertDocumentSceneAt(std::shared_ptr<UBDocumentProxy> pDocumentProxy, std::shared_ptr<UBGraphicsScene> scene, int index, bool persist = true, bool deleting = false);
 
@@ -145,6 +145,9 @@ class UBPersistenceManager : public QObject
 
         bool addGraphicsWidgetToDocument(std::shared_ptr<UBDocumentProxy> mDocumentProxy, QString path, QUuid objectUuid, QString& destinationPath);
         bool addFileToDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy, QString path, const QString& subdir,  QUuid objectUuid, QString& destinationPath, QByteArray* data = NULL);
+        bool moveFileToDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy, QString path, const QString& subdir,  QUuid objectUuid, QString& destinationPath);
+        QString documentFilePath(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QString& path, const QString& subdir, QUuid objectUuid) const;
+        bool linkFileToDocument(const QString& sourcePath, const QString& destinationPath, bool temporarySource = false) const;
 
         bool mayHaveVideo(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         bool mayHaveAudio(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
@@ -155,7 +158,17 @@ class UBPersistenceManager : public QObject
         QString adjustDocumentVirtualPath(const QString &str);
 
         void closing();
+
+        /**
+         * Copied pages reference assets that are copied in the background, and video posters
+         * are written in the background. Anything reading a document directory outside of
+         * loadDocumentScene() must wait for them first.
+         */
+        void waitForAssetCopies();
+        void trackAssetCopy(const QFuture<void>& assetCopy);
+
         bool isSceneInCached(std::shared_ptr<UBDocumentProxy>proxy, int index) const;
+        bool isSceneInCached(std::shared_ptr<UBGraphicsScene> scene) const;
 
     signals:
         void documentCreated(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
@@ -168,7 +181,7 @@ private:
         static QStringList getSceneFileNames(const QString& folder);
         void renamePage(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
                         const int sourceIndex, const int targetIndex);
-        void copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
+        bool copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
                       const int sourceIndex, const int targetIndex);
         void generatePathIfNeeded(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         void checkIfDocumentRepositoryExists();
@@ -190,6 +203,7 @@ private:
         QFutureWatcher<void> futureWatcher;
         UBPersistenceWorker* mWorker;
         QList<std::shared_ptr<UBGraphicsScene>> mScenesToSave;
+        QList<QFuture<void>> mAssetCopies;
 
         QThread* mThread;
         bool mIsWorkerFinished;
@@ -27,6 +27,7 @@
 
 
 #include "UBPersistenceWorker.h"
+#include "UBTrace.h"
 #include "adaptors/UBSvgSubsetAdaptor.h"
 #include "adaptors/UBThumbnailAdaptor.h"
 #include "adaptors/UBMetadataDcSubsetAdaptor.h"
@@ -43,6 +44,7 @@ void UBPersistenceWorker::saveScene(std::shared_ptr<UBDocumentProxy> proxy, UBGr
 
     QMutexLocker locker(&mMutex);
     saves.append(entry);
+    UBTrace::count("persistence.queue");
     mSemaphore.release();
 }
 
@@ -51,6 +53,7 @@ void UBPersistenceWorker::saveMetadata(std::shared_ptr<UBDocumentProxy> proxy)
     PersistenceInformation entry = {WriteMetadata, proxy, NULL, 0};
     QMutexLocker locker(&mMutex);
     saves.append(entry);
+    UBTrace::count("persistence.queue");
     mSemaphore.release();
 }
 
@@ -70,12 +73,15 @@ void UBPersistenceWorker::process()
         {
             QMutexLocker locker(&mMutex);
             info = saves.takeFirst();
+            UBTrace::count("persistence.queue", -1);
         }
         if(info.action == WriteScene){
+            UB_TRACE_SCOPE("persistence", "workerWriteScene");
             UBSvgSubsetAdaptor::persistScene(info.proxy, info.scene->shared_from_this(), info.sceneIndex);
             emit scenePersisted(info.scene);
         }
         else if (info.action == WriteMetadata) {
+            UB_TRACE_SCOPE("persistence", "workerWriteMetadata");
             UBMetadataDcSubsetAdaptor::persist(info.proxy);
             emit metadataPersisted(info.proxy);
         }
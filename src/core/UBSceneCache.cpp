@@ -35,6 +35,7 @@
 #include "core/UBApplication.h"
 #include "core/UBSettings.h"
 #include "core/UBSetting.h"
+#include "core/UBTrace.h"
 
 #include "document/UBDocumentProxy.h"
 
@@ -111,6 +112,25 @@ bool UBSceneCache::contains(std::shared_ptr<UBDocumentProxy> proxy, int pageInde
 }
 
 
+bool UBSceneCache::containsScene(std::shared_ptr<UBGraphicsScene> scene) const
+{
+    if (!scene)
+    {
+        return false;
+    }
+
+    for (const auto& entry : mSceneCache)
+    {
+        if (entry->isSceneAvailable() && entry->scene() == scene)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 std::shared_ptr<UBGraphicsScene> UBSceneCache::value(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
 {
     UBSceneCacheID key{proxy, pageIndex};
@@ -122,10 +142,12 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::value(std::shared_ptr<UBDocumentP
         mCachedKeyFIFO.removeAll(key);
         mCachedKeyFIFO.enqueue(key);
 
+        UBTrace::count("scenecache.hit");
         return entry->scene();
     }
     else
     {
+        UBTrace::count("scenecache.miss");
         return nullptr;
     }
 }
@@ -88,6 +88,8 @@ public:
 
     bool contains(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex) const;
 
+    bool containsScene(std::shared_ptr<UBGraphicsScene> scene) const;
+
     std::shared_ptr<UBGraphicsScene> value(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
 
     void removeScene(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
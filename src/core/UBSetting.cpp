@@ -37,6 +37,12 @@
 
 UBSetting::UBSetting(UBSettings* parent) :
     QObject(parent)
+    , mOwner(parent)
+    , mCached(false)
+    , mDecoded(0)
+    , mBoolValue(false)
+    , mIntValue(0)
+    , mRealValue(0)
 {
     //NOOP
 }
@@ -48,8 +54,16 @@ UBSetting::UBSetting(UBSettings* owner, const QString& pDomain, const QString& p
         mDomain(pDomain), 
         mKey(pKey), 
         mPath(pDomain + "/" + pKey), 
-        mDefaultValue(pDefaultValue)
+        mDefaultValue(pDefaultValue),
+        mCached(false),
+        mDecoded(0),
+        mBoolValue(false),
+        mIntValue(0),
+        mRealValue(0)
 {
+    // the owner keeps the cache up to date when the value is changed by its path
+    mOwner->mSettingsByPath.insert(mPath, this);
+
     get(); // force caching of the setting
 }
 
@@ -69,7 +83,93 @@ void UBSetting::set(const QVariant& pValue)
 
 QVariant UBSetting::get()
 {
-    return mOwner->value(mPath, mDefaultValue);
+    if (!mCached)
+        cacheValue(mOwner->value(mPath, mDefaultValue));
+
+    return mValue;
+}
+
+bool UBSetting::getBool()
+{
+    if (!mCached || !(mDecoded & DecodedBool))
+    {
+        mBoolValue = get().toBool();
+        mDecoded |= DecodedBool;
+    }
+
+    return mBoolValue;
+}
+
+int UBSetting::getInt()
+{
+    if (!mCached || !(mDecoded & DecodedInt))
+    {
+        mIntValue = get().toInt();
+        mDecoded |= DecodedInt;
+    }
+
+    return mIntValue;
+}
+
+qreal UBSetting::getReal()
+{
+    if (!mCached || !(mDecoded & DecodedReal))
+    {
+        mRealValue = get().toReal();
+        mDecoded |= DecodedReal;
+    }
+
+    return mRealValue;
+}
+
+QString UBSetting::getString()
+{
+    if (!mCached || !(mDecoded & DecodedString))
+    {
+        mStringValue = get().toString();
+        mDecoded |= DecodedString;
+    }
+
+    return mStringValue;
+}
+
+QColor UBSetting::getColor()
+{
+    if (!mCached || !(mDecoded & DecodedColor))
+    {
+        QVariant value = get();
+
+        if (value.userType() == QMetaType::QColor)
+        {
+            mColorValue = value.value<QColor>();
+        }
+        else
+        {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 4, 0))
+            mColorValue = QColor::fromString(value.toString());
+#else
+            mColorValue = QColor(value.toString());
+#endif
+        }
+
+        mDecoded |= DecodedColor;
+    }
+
+    return mColorValue;
+}
+
+void UBSetting::cacheValue(const QVariant& pValue)
+{
+    mValue = pValue;
+    mDecoded = 0;
+    mCached = true;
+}
+
+void UBSetting::invalidateCache()
+{
+    mValue = QVariant();
+    mDecoded = 0;
+    mCached = false;
 }
 
 QVariant UBSetting::reset()
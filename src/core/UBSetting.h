@@ -69,6 +69,13 @@ class UBSetting : public QObject
             return mDefaultValue;
         }
 
+        // Typed accessors, decoded once and kept until the value changes. Use these on hot paths.
+        bool getBool();
+        int getInt();
+        qreal getReal();
+        QString getString();
+        QColor getColor();
+
     public slots:
 
         void setBool(bool pValue);
@@ -86,6 +93,31 @@ class UBSetting : public QObject
         QString mKey;
         QString mPath;
         QVariant mDefaultValue;
+
+    private:
+        friend class UBSettings;
+
+        void cacheValue(const QVariant& pValue);
+        void invalidateCache();
+
+        enum DecodedType
+        {
+            DecodedBool = 0x01,
+            DecodedInt = 0x02,
+            DecodedReal = 0x04,
+            DecodedString = 0x08,
+            DecodedColor = 0x10
+        };
+
+        bool mCached;
+        int mDecoded;
+        QVariant mValue;
+
+        bool mBoolValue;
+        int mIntValue;
+        qreal mRealValue;
+        QString mStringValue;
+        QColor mColorValue;
 };
 
 
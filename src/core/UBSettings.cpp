@@ -270,6 +270,7 @@ void UBSettings::init()
 
     appStartMode = new UBSetting(this, "App", "StartMode", "");
     appRunInWindow = new UBSetting(this, "App", "RunInWindow", false);
+    appTraceEnabled = new UBSetting(this, "App", "TraceEnabled", false);
 
     featureSliderPosition = new UBSetting(this, "Board", "FeatureSliderPosition", 40);
 
@@ -526,6 +527,11 @@ void UBSettings::setValue (const QString & key, const QVariant & value)
 {
     // Save the setting to the queue only; a call to save() is necessary to persist the settings
     mSettingsQueue[key] = value;
+
+    // Keep the decoded value of the matching UBSetting in sync
+    UBSetting* setting = mSettingsByPath.value(key);
+    if (setting)
+        setting->cacheValue(value);
 }
 
 /**
@@ -599,18 +605,18 @@ qreal UBSettings::currentPenWidth()
     switch (penWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->getReal();
             break;
         case UBWidth::Medium:
-            width = boardPenMediumWidth->get().toDouble();
+            width = boardPenMediumWidth->getReal();
             break;
         case UBWidth::Strong:
-            width = boardPenStrongWidth->get().toDouble();
+            width = boardPenStrongWidth->getReal();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->getReal();
             break;
     }
 
@@ -681,18 +687,18 @@ qreal UBSettings::currentMarkerWidth()
     switch (markerWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->getReal();
             break;
         case UBWidth::Medium:
-            width = boardMarkerMediumWidth->get().toDouble();
+            width = boardMarkerMediumWidth->getReal();
             break;
         case UBWidth::Strong:
-            width = boardMarkerStrongWidth->get().toDouble();
+            width = boardMarkerStrongWidth->getReal();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->getReal();
             break;
     }
 
@@ -1479,6 +1485,10 @@ void UBSettings::removeSetting(const QString &setting)
 
     if (mSettingsQueue.contains(setting))
         mSettingsQueue.remove(setting);
+
+    UBSetting* cachedSetting = mSettingsByPath.value(setting);
+    if (cachedSetting)
+        cachedSetting->invalidateCache();
 }
 
 void UBSettings::checkNewSettings()
@@ -264,6 +264,7 @@ class UBSettings : public QObject
         UBSetting* appToolBarOrientationVertical;
         UBSetting* appPreferredLanguage;
         UBSetting* appRunInWindow;
+        UBSetting* appTraceEnabled;
 
         UBSetting* appIsInSoftwareUpdateProcess;
 
@@ -461,11 +462,13 @@ class UBSettings : public QObject
         void colorContextChanged();
 
     private:
+        friend class UBSetting;
 
         QSettings* mAppSettings;
         QSettings* mUserSettings;
 
         QHash<QString, QVariant> mSettingsQueue;
+        QHash<QString, UBSetting*> mSettingsByPath;
 
         static const int sDefaultFontPixelSize;
         static const char *sDefaultFontFamily;
@@ -30,13 +30,12 @@
 
 QString UBTextTools::cleanHtmlCData(const QString &_html){
 
-    QString clean = "";
+    QString clean = _html;
 
+    // in place and without detaching when there is nothing to remove
+    if (clean.contains(QChar('\0')))
+        clean.remove(QChar('\0'));
 
-    for(int i = 0; i < _html.length(); i+=1){
-        if(_html.at(i) != '\0')
-            clean.append(_html.at(i));
-    }
     return clean;
 }
 
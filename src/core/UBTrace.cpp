@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include "UBTrace.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/UBSettings.h"
+
+#include "core/memcheck.h"
+
+// interval of the counter snapshots
+static const int sSnapshotInterval = 1000;
+
+// the GUI thread is considered stalled when a timer fires later than this
+static const int sStallCheckInterval = 50;
+static const int sStallThreshold = 100;
+
+// bound the memory used by a long tracing session
+static const int sMaxEvents = 2000000;
+
+std::atomic<bool> UBTrace::sEnabled(false);
+
+
+// names come from the code but also from object names, they are written as JSON strings
+static QString jsonString(const QByteArray& utf8)
+{
+    QByteArray array = QJsonDocument(QJsonArray() << QString::fromUtf8(utf8)).toJson(QJsonDocument::Compact);
+
+    // strip the brackets of the array
+    return QString::fromUtf8(array.mid(1, array.size() - 2));
+}
+
+
+struct UBTrace::State
+{
+    struct Event
+    {
+        QByteArray category;
+        QByteArray name;
+        char phase;
+        qint64 timestamp;
+        qint64 duration;
+        qint64 value;
+        int threadId;
+    };
+
+    struct Sample
+    {
+        qint64 count;
+        qint64 total;
+        qint64 maximum;
+    };
+
+    QMutex mutex;
+    QElapsedTimer clock;
+    QString outputPath;
+    QVector<Event> events;
+    qint64 droppedEvents = 0;
+
+    QMap<QByteArray, qint64> counters;
+    QMap<QByteArray, Sample> samples;
+    QMap<QString, std::function<qint64()>> providers;
+
+    QObject* timerOwner = nullptr;
+    QElapsedTimer sinceStallCheck;
+
+    std::atomic<int> nextThreadId{0};
+};
+
+
+UBTrace::State& UBTrace::state()
+{
+    static State traceState;
+    return traceState;
+}
+
+
+void UBTrace::start(const QString& outputPath)
+{
+    if (isEnabled())
+        return;
+
+    State& s = state();
+
+    {
+        QMutexLocker locker(&s.mutex);
+        s.outputPath = outputPath;
+        s.events.clear();
+        s.droppedEvents = 0;
+        s.counters.clear();
+        s.samples.clear();
+        s.clock.start();
+    }
+
+    sEnabled = true;
+
+    qDebug() << "tracing to" << outputPath;
+
+    if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread())
+    {
+        s.timerOwner = new QObject();
+
+        QTimer* snapshotTimer = new QTimer(s.timerOwner);
+        QObject::connect(snapshotTimer, &QTimer::timeout, &UBTrace::snapshot);
+        snapshotTimer->start(sSnapshotInterval);
+
+        QTimer* stallTimer = new QTimer(s.timerOwner);
+        QObject::connect(stallTimer, &QTimer::timeout, &UBTrace::checkStall);
+        s.sinceStallCheck.start();
+        stallTimer->start(sStallCheckInterval);
+    }
+}
+
+
+void UBTrace::stop()
+{
+    if (!isEnabled())
+        return;
+
+    State& s = state();
+
+    snapshot();
+
+    sEnabled = false;
+
+    delete s.timerOwner;
+    s.timerOwner = nullptr;
+
+    write(s.outputPath);
+
+    QMutexLocker locker(&s.mutex);
+    s.events.clear();
+    s.events.squeeze();
+}
+
+
+qint64 UBTrace::now()
+{
+    State& s = state();
+    return s.clock.isValid() ? s.clock.nsecsElapsed() / 1000 : 0;
+}
+
+
+void UBTrace::complete(const char* category, const char* name, qint64 start, qint64 duration)
+{
+    if (isEnabled())
+        record('X', QByteArray::fromRawData(category, qstrlen(category)), QByteArray::fromRawData(name, qstrlen(name)), start, duration);
+}
+
+
+void UBTrace::instant(const char* category, const char* name)
+{
+    if (isEnabled())
+        record('i', QByteArray::fromRawData(category, qstrlen(category)), QByteArray::fromRawData(name, qstrlen(name)), now());
+}
+
+
+void UBTrace::count(const char* name, qint64 delta)
+{
+    if (!isEnabled())
+        return;
+
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+    s.counters[QByteArray(name)] += delta;
+}
+
+
+void UBTrace::sample(const char* name, qint64 value)
+{
+    if (!isEnabled())
+        return;
+
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+
+    State::Sample& entry = s.samples[QByteArray(name)];
+    entry.count++;
+    entry.total += value;
+    entry.maximum = qMax(entry.maximum, value);
+}
+
+
+void UBTrace::registerCounter(const QString& name, std::function<qint64()> provider)
+{
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+    s.providers.insert(name, provider);
+}
+
+
+void UBTrace::unregisterCounter(const QString& name)
+{
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+    s.providers.remove(name);
+}
+
+
+QString UBTrace::defaultOutputPath()
+{
+    return UBSettings::userDataDirectory() + "/log/trace-"
+            + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".json";
+}
+
+
+void UBTrace::record(char phase, const QByteArray& category, const QByteArray& name, qint64 timestamp, qint64 duration, qint64 value)
+{
+    int tid = threadId();
+
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+
+    if (!isEnabled())
+        return;
+
+    if (s.events.size() >= sMaxEvents)
+    {
+        s.droppedEvents++;
+        return;
+    }
+
+    // copy the names, literals passed as raw data must not be referenced after tracing
+    State::Event event = {QByteArray(category.constData(), category.size()), QByteArray(name.constData(), name.size()),
+                          phase, timestamp, duration, value, tid};
+    s.events.append(event);
+}
+
+
+void UBTrace::snapshot()
+{
+    State& s = state();
+    QMap<QString, std::function<qint64()>> providers;
+    QMap<QByteArray, qint64> counters;
+    QMap<QByteArray, State::Sample> samples;
+
+    {
+        QMutexLocker locker(&s.mutex);
+        providers = s.providers;
+        counters = s.counters;
+        samples = s.samples;
+        s.samples.clear();
+    }
+
+    qint64 timestamp = now();
+
+    for (auto it = providers.constBegin(); it != providers.constEnd(); ++it)
+        record('C', "counter", it.key().toUtf8(), timestamp, 0, it.value()());
+
+    for (auto it = counters.constBegin(); it != counters.constEnd(); ++it)
+        record('C', "counter", it.key(), timestamp, 0, it.value());
+
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it)
+    {
+        qint64 mean = it.value().count ? it.value().total / it.value().count : 0;
+        record('C', "counter", it.key() + ".mean", timestamp, 0, mean);
+        record('C', "counter", it.key() + ".max", timestamp, 0, it.value().maximum);
+    }
+}
+
+
+void UBTrace::checkStall()
+{
+    State& s = state();
+
+    qint64 lateness = s.sinceStallCheck.restart() - sStallCheckInterval;
+
+    if (lateness > sStallThreshold)
+    {
+        record('X', "gui", "stall", now() - lateness * 1000, lateness * 1000);
+        count("gui.stalls");
+        sample("gui.stall_ms", lateness);
+    }
+}
+
+
+int UBTrace::threadId()
+{
+    static thread_local int id = -1;
+
+    if (id < 0)
+    {
+        State& s = state();
+        id = s.nextThreadId++;
+
+        QThread* thread = QThread::currentThread();
+        QString threadName = thread ? thread->objectName() : QString();
+
+        if (threadName.isEmpty())
+        {
+            if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+                threadName = "GUI";
+            else
+                threadName = QString("thread %1").arg(id);
+        }
+
+        // metadata event naming the thread in the trace viewer
+        record('M', "__metadata", threadName.toUtf8(), 0);
+    }
+
+    return id;
+}
+
+
+bool UBTrace::write(const QString& outputPath)
+{
+    State& s = state();
+    QMutexLocker locker(&s.mutex);
+
+    QFileInfo(outputPath).absoluteDir().mkpath(".");
+
+    QFile file(outputPath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qWarning() << "cannot write trace to" << outputPath;
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"droppedEvents\":" << s.droppedEvents << ",\"traceEvents\":[\n";
+
+    for (int i = 0; i < s.events.size(); ++i)
+    {
+        const State::Event& event = s.events.at(i);
+
+        if (i > 0)
+            out << ",\n";
+
+        if (event.phase == 'M')
+        {
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event.threadId
+                << ",\"args\":{\"name\":" << jsonString(event.name) << "}}";
+            continue;
+        }
+
+        out << "{\"name\":" << jsonString(event.name) << ",\"cat\":" << jsonString(event.category)
+            << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.timestamp
+            << ",\"pid\":1,\"tid\":" << event.threadId;
+
+        if (event.phase == 'X')
+            out << ",\"dur\":" << event.duration;
+        else if (event.phase == 'i')
+            out << ",\"s\":\"t\"";
+        else if (event.phase == 'C')
+            out << ",\"args\":{\"value\":" << event.value << "}";
+
+        out << "}";
+    }
+
+    out << "\n]}\n";
+
+    qDebug() << "trace with" << s.events.size() << "events written to" << outputPath;
+
+    return true;
+}
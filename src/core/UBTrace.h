@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef UBTRACE_H_
+#define UBTRACE_H_
+
+#include <QtCore>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Lightweight tracing of the board pipeline.
+ *
+ * Scoped events and counters are recorded in memory while tracing is enabled and written as
+ * Chrome trace-event JSON (chrome://tracing, Perfetto) when tracing stops. When tracing is
+ * disabled, a trace scope only costs the test of an atomic flag.
+ *
+ * Tracing is enabled with the App/TraceEnabled setting or with the --trace[=<file>] argument.
+ */
+class UBTrace
+{
+    public:
+        static bool isEnabled()
+        {
+            return sEnabled.load(std::memory_order_relaxed);
+        }
+
+        static void start(const QString& outputPath);
+        static void stop();
+
+        // microseconds since tracing started
+        static qint64 now();
+
+        static void complete(const char* category, const char* name, qint64 start, qint64 duration);
+        static void instant(const char* category, const char* name);
+
+        // cumulative counter, e.g. cache hits or queued jobs
+        static void count(const char* name, qint64 delta = 1);
+
+        // sampled value, reported as mean and maximum since the last snapshot
+        static void sample(const char* name, qint64 value);
+
+        // value read at each snapshot, e.g. a queue depth
+        static void registerCounter(const QString& name, std::function<qint64()> provider);
+        static void unregisterCounter(const QString& name);
+
+        static QString defaultOutputPath();
+
+    private:
+        struct State;
+        static State& state();
+
+        static void record(char phase, const QByteArray& category, const QByteArray& name, qint64 timestamp, qint64 duration = 0, qint64 value = 0);
+        static void snapshot();
+        static void checkStall();
+        static int threadId();
+        static bool write(const QString& outputPath);
+
+        static std::atomic<bool> sEnabled;
+};
+
+
+class UBTraceScope
+{
+    public:
+        UBTraceScope(const char* category, const char* name, const char* sampleName = nullptr)
+            : mCategory(category)
+            , mName(name)
+            , mSampleName(sampleName)
+            , mStart(UBTrace::isEnabled() ? UBTrace::now() : -1)
+        {
+            // NOOP
+        }
+
+        ~UBTraceScope()
+        {
+            if (mStart >= 0 && UBTrace::isEnabled())
+            {
+                qint64 duration = UBTrace::now() - mStart;
+                UBTrace::complete(mCategory, mName, mStart, duration);
+
+                if (mSampleName)
+                    UBTrace::sample(mSampleName, duration);
+            }
+        }
+
+    private:
+        const char* mCategory;
+        const char* mName;
+        const char* mSampleName;
+        qint64 mStart;
+};
+
+#define UB_TRACE_CONCAT_(a, b) a##b
+#define UB_TRACE_CONCAT(a, b) UB_TRACE_CONCAT_(a, b)
+
+// trace the enclosing scope, category and name must be string literals
+#define UB_TRACE_SCOPE(category, name) UBTraceScope UB_TRACE_CONCAT(ubTraceScope, __LINE__)(category, name)
+
+// trace the enclosing scope and sample its duration in microseconds as a counter
+#define UB_TRACE_SCOPE_SAMPLED(category, name, sampleName) UBTraceScope UB_TRACE_CONCAT(ubTraceScope, __LINE__)(category, name, sampleName)
+
+#endif /* UBTRACE_H_ */
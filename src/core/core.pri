@@ -15,6 +15,7 @@ HEADERS      += src/core/UB.h \
                 src/core/UBDownloadManager.h \
                 src/core/UBDownloadThread.h \
                 src/core/UBTextTools.h \
+                src/core/UBTrace.h \
     src/core/UBPersistenceWorker.h \
     $$PWD/UBForeignObjectsHandler.h
 
@@ -34,5 +35,6 @@ SOURCES      += src/core/main.cpp \
                 src/core/UBDownloadManager.cpp \
                 src/core/UBDownloadThread.cpp \
                 src/core/UBTextTools.cpp \
+                src/core/UBTrace.cpp \
     src/core/UBPersistenceWorker.cpp \
     $$PWD/UBForeignObjectsHandler.cpp
@@ -74,6 +74,7 @@ UBDesktopAnnotationController::UBDesktopAnnotationController(QObject *parent, UB
         , mPendingEraserButtonPressed(false)
         , mbArrowClicked(false)
         , mCustomCaptureClicked(false)
+        , mMaskTransparent(false)
         , mBoardStylusTool(UBDrawingController::drawingController()->stylusTool())
         , mDesktopStylusTool(UBDrawingController::drawingController()->stylusTool())
 {
@@ -169,6 +170,12 @@ UBDesktopAnnotationController::UBDesktopAnnotationController(QObject *parent, UB
     connect(&mHoldTimerEraser, SIGNAL(timeout()), this, SLOT(eraserActionReleased()));
 
 #ifdef UB_REQUIRES_MASK_UPDATE
+    mMaskUpdateTimer.setSingleShot(true);
+    mMaskUpdateTimer.setInterval(16);
+    connect(&mMaskUpdateTimer, SIGNAL(timeout()), this, SLOT(applyMask()));
+    connect(mTransparentDrawingScene.get(), &UBGraphicsScene::polygonItemAdded, this, &UBDesktopAnnotationController::annotationAdded);
+    connect(mTransparentDrawingScene.get(), &UBGraphicsScene::polygonItemRemoved, this, &UBDesktopAnnotationController::annotationRemoved);
+
     connect(mDesktopPalette, SIGNAL(moving()), this, SLOT(refreshMask()));
     connect(UBApplication::boardController->paletteManager()->rightPalette(), SIGNAL(resized()), this, SLOT(refreshMask()));
     connect(UBApplication::boardController->paletteManager()->addItemPalette(), SIGNAL(closed()), this, SLOT(refreshMask()));
@@ -348,6 +355,7 @@ void UBDesktopAnnotationController::showWindow()
     mDesktopPalette->appear();
 
 #ifdef UB_REQUIRES_MASK_UPDATE
+    rebuildAnnotationRegion();
     updateMask(true);
 #endif // UB_REQUIRES_MASK_UPDATE
 }
@@ -394,6 +402,7 @@ void UBDesktopAnnotationController::updateBackground()
     {
         newBrush = QBrush(Qt::transparent);
 #ifdef UB_REQUIRES_MASK_UPDATE
+        rebuildAnnotationRegion();
         updateMask(true);
 #endif //UB_REQUIRES_MASK_UPDATE
     }
@@ -831,116 +840,116 @@ void UBDesktopAnnotationController::onTransparentWidgetResized()
 
 void UBDesktopAnnotationController::updateMask(bool bTransparent)
 {
-    if(bTransparent)
-    {
-        // Here we have to generate a new mask This method is certainly resource
-        // consuming but for the moment this is the only solution that I found.
-        mMask = QPixmap(mTransparentDrawingView->width(), mTransparentDrawingView->height());
-        mMask.fill(Qt::transparent);
+    // a mask update is applied right away, drop any coalesced refresh still pending
+    mMaskUpdateTimer.stop();
+    mMaskTransparent = bTransparent;
 
-        QPainter p;
+    QRegion mask;
 
-        p.begin(&mMask);
-
-        p.setPen(Qt::red);
-        p.setBrush(QBrush(Qt::red));
+    if(bTransparent)
+    {
+        UBBoardPaletteManager* paletteManager = UBApplication::boardController->paletteManager();
 
-        // Here we draw the widget mask
+        // Here we add the widget mask. Rects are grown by one pixel to match the
+        // outline drawn by a cosmetic pen, as the former pixmap based mask did.
         if(mDesktopPalette->isVisible())
         {
-            p.drawRect(mDesktopPalette->geometry().x(), mDesktopPalette->geometry().y(), mDesktopPalette->width(), mDesktopPalette->height());
+            mask += mDesktopPalette->geometry().adjusted(0, 0, 1, 1);
         }
-        if(UBApplication::boardController->paletteManager()->mKeyboardPalette->isVisible())
+
+        if(paletteManager->mKeyboardPalette->isVisible())
         {
-            p.drawRect(UBApplication::boardController->paletteManager()->mKeyboardPalette->geometry().x(), UBApplication::boardController->paletteManager()->mKeyboardPalette->geometry().y(),
-                       UBApplication::boardController->paletteManager()->mKeyboardPalette->width(), UBApplication::boardController->paletteManager()->mKeyboardPalette->height());
+            mask += paletteManager->mKeyboardPalette->geometry().adjusted(0, 0, 1, 1);
         }
 
-        if(UBApplication::boardController->paletteManager()->leftPalette()->isVisible())
+        if(paletteManager->leftPalette()->isVisible())
         {
-            QRect leftPalette(UBApplication::boardController->paletteManager()->leftPalette()->geometry().x(),
-                        UBApplication::boardController->paletteManager()->leftPalette()->geometry().y(),
-                        UBApplication::boardController->paletteManager()->leftPalette()->width(),
-                        UBApplication::boardController->paletteManager()->leftPalette()->height());
-
-            QRect tabsPalette(UBApplication::boardController->paletteManager()->leftPalette()->getTabPaletteRect());
-
-            p.drawRect(leftPalette);
-            p.drawRect(tabsPalette);
+            mask += paletteManager->leftPalette()->geometry().adjusted(0, 0, 1, 1);
+            mask += paletteManager->leftPalette()->getTabPaletteRect().adjusted(0, 0, 1, 1);
         }
 
-        if(UBApplication::boardController->paletteManager()->rightPalette()->isVisible())
+        if(paletteManager->rightPalette()->isVisible())
         {
-            QRect rightPalette(UBApplication::boardController->paletteManager()->rightPalette()->geometry().x(),
-                        UBApplication::boardController->paletteManager()->rightPalette()->geometry().y(),
-                        UBApplication::boardController->paletteManager()->rightPalette()->width(),
-                        UBApplication::boardController->paletteManager()->rightPalette()->height());
-
-            QRect tabsPalette(UBApplication::boardController->paletteManager()->rightPalette()->getTabPaletteRect());
-
-            p.drawRect(rightPalette);
-            p.drawRect(tabsPalette);
+            mask += paletteManager->rightPalette()->geometry().adjusted(0, 0, 1, 1);
+            mask += paletteManager->rightPalette()->getTabPaletteRect().adjusted(0, 0, 1, 1);
         }
 
         //Rquiered only for compiz wm
         //TODO. Window manager detection screen
 
-        if (UBApplication::boardController->paletteManager()->addItemPalette()->isVisible()) {
-            p.drawRect(UBApplication::boardController->paletteManager()->addItemPalette()->geometry());
+        if (paletteManager->addItemPalette()->isVisible()) {
+            mask += paletteManager->addItemPalette()->geometry().adjusted(0, 0, 1, 1);
         }
 
+        // Then we add the annotations
+        mask += mAnnotationRegion;
+    }
+    else
+    {
+        mask = QRegion(0, 0, mTransparentDrawingView->width() + 1, mTransparentDrawingView->height() + 1);
+    }
 
-        p.end();
-
-        // Then we add the annotations. We create another painter because we need to
-        // apply transformations on it for coordinates matching
-        QPainter annotationPainter;
-
-        QTransform trans;
-        trans.translate(mTransparentDrawingView->width()/2, mTransparentDrawingView->height()/2);
+    if (mask != mTransparentDrawingView->mask())
+        mTransparentDrawingView->setMask(mask);
+}
 
-        annotationPainter.begin(&mMask);
-        annotationPainter.setPen(Qt::red);
-        annotationPainter.setBrush(Qt::red);
+QRect UBDesktopAnnotationController::annotationRect(QGraphicsItem* item) const
+{
+    return mTransparentDrawingView->mapFromScene(item->sceneBoundingRect()).boundingRect().adjusted(0, 0, 1, 1);
+}
 
-        annotationPainter.setTransform(trans);
+/**
+ * \brief Recompute the region covered by the annotations from the scene, when strokes may have moved. Strokes added
+ * or removed in between are merged incrementally.
+ */
+void UBDesktopAnnotationController::rebuildAnnotationRegion()
+{
+    mAnnotationRects.clear();
+    mAnnotationRegion = QRegion();
 
-        QList<QGraphicsItem*> allItems = mTransparentDrawingScene->items();
+    const QList<QGraphicsItem*> allItems = mTransparentDrawingScene->items();
 
-        for(int i = 0; i < allItems.size(); i++)
+    for (QGraphicsItem* pCrntItem : allItems)
+    {
+        if(pCrntItem->isVisible() && pCrntItem->type() == UBGraphicsPolygonItem::Type)
         {
-            QGraphicsItem* pCrntItem = allItems.at(i);
-
-            if(pCrntItem->isVisible() && pCrntItem->type() == UBGraphicsPolygonItem::Type)
-            {
-                QPainterPath crntPath = pCrntItem->shape();
-                QRectF rect = crntPath.boundingRect();
-
-                annotationPainter.drawRect(rect);
-            }
+            QRect rect = annotationRect(pCrntItem);
+            mAnnotationRects.insert(pCrntItem, rect);
+            mAnnotationRegion += rect;
         }
+    }
+}
+
+void UBDesktopAnnotationController::annotationAdded(QGraphicsItem* item)
+{
+    QRect rect = annotationRect(item);
 
-        annotationPainter.end();
+    mAnnotationRects.insert(item, rect);
+    mAnnotationRegion += rect;
 
-        mTransparentDrawingView->setMask(mMask.mask());
-    }
-    else
-    {
-        mMask = QPixmap(mTransparentDrawingView->width(), mTransparentDrawingView->height());
-        mMask.fill(Qt::transparent);
+    annotationsChanged();
+}
 
-        QPainter p;
+void UBDesktopAnnotationController::annotationRemoved(QGraphicsItem* item)
+{
+    QHash<QGraphicsItem*, QRect>::iterator removed = mAnnotationRects.find(item);
 
-        p.begin(&mMask);
+    if (removed == mAnnotationRects.end())
+        return;
 
-        p.setPen(Qt::red);
-        p.setBrush(QBrush(Qt::red));
+    QRect rect = removed.value();
+    mAnnotationRects.erase(removed);
 
-        p.drawRect(0, 0, mTransparentDrawingView->width(), mTransparentDrawingView->height());
-        p.end();
+    // the region cannot be shrunk by the rect alone, the cached rects overlapping it are merged again
+    mAnnotationRegion -= rect;
 
-        mTransparentDrawingView->setMask(mMask.mask());
+    for (QHash<QGraphicsItem*, QRect>::const_iterator it = mAnnotationRects.constBegin(); it != mAnnotationRects.constEnd(); ++it)
+    {
+        if (it.value().intersects(rect))
+            mAnnotationRegion += it.value() & rect;
     }
+
+    annotationsChanged();
 }
 
 void UBDesktopAnnotationController::refreshMask()
@@ -954,11 +963,28 @@ void UBDesktopAnnotationController::refreshMask()
                 || UBDrawingController::drawingController()->stylusTool() == UBStylusTool::Pen
                 || UBDrawingController::drawingController()->stylusTool() == UBStylusTool::Marker)
         {
-            updateMask(true);
+            // palettes report every move step, coalesce them to one mask update per frame
+            if (!mMaskUpdateTimer.isActive())
+                mMaskUpdateTimer.start();
         }
     }
 }
 
+void UBDesktopAnnotationController::annotationsChanged()
+{
+    // the annotations are only part of the mask when the drawing view lets the input through
+    if (mMaskTransparent
+            && (mIsFullyTransparent || UBDrawingController::drawingController()->stylusTool() == UBStylusTool::Selector))
+    {
+        refreshMask();
+    }
+}
+
+void UBDesktopAnnotationController::applyMask()
+{
+    updateMask(true);
+}
+
 void UBDesktopAnnotationController::onToolClicked()
 {
     mDesktopEraserPalette->hide();
@@ -126,12 +126,18 @@ class UBDesktopAnnotationController : public QObject
         void onDesktopPaletteMinimize();
         void onTransparentWidgetResized();
         void refreshMask();
+        void annotationsChanged();
+        void annotationAdded(QGraphicsItem* item);
+        void annotationRemoved(QGraphicsItem* item);
+        void applyMask();
         void onToolClicked();
 
     private:
         void setAssociatedPalettePosition(UBActionPalette* palette, const QString& actionName);
         void togglePropertyPalette(UBActionPalette* palette);
         void updateMask(bool bTransparent);
+        QRect annotationRect(QGraphicsItem* item) const;
+        void rebuildAnnotationRegion();
 
         UBDesktopPalette *mDesktopPalette;
         //UBKeyboardPalette *mKeyboardPalette;
@@ -156,11 +162,15 @@ class UBDesktopAnnotationController : public QObject
         bool mPendingEraserButtonPressed;
         bool mbArrowClicked;
         bool mCustomCaptureClicked;
+        bool mMaskTransparent;
 
         int mBoardStylusTool;
         int mDesktopStylusTool;
 
-        QPixmap mMask;
+        QTimer mMaskUpdateTimer;
+        // view rect of each stroke polygon of the annotation scene, merged into mAnnotationRegion
+        QHash<QGraphicsItem*, QRect> mAnnotationRects;
+        QRegion mAnnotationRegion;
 
 };
 
@@ -53,9 +53,9 @@ void UBDocumentContainer::setDocument(std::shared_ptr<UBDocumentProxy> document,
     }
 }
 
-void UBDocumentContainer::duplicatePage(int index)
+bool UBDocumentContainer::duplicatePage(int index)
 {
-    UBPersistenceManager::persistenceManager()->duplicateDocumentScene(mCurrentDocument, index);
+    return UBPersistenceManager::persistenceManager()->duplicateDocumentScene(mCurrentDocument, index);
 }
 
 void UBDocumentContainer::moveThumbPage(int source, int target)
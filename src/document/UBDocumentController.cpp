@@ -737,8 +737,7 @@ bool UBDocumentTreeModel::dropMimeData(const QMimeData *data, Qt::DropAction act
             return false;
         }
 
-//        int count = 0;
-        int total = ubMime->items().size();
+        int total = 0;
 
         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
@@ -748,8 +747,9 @@ bool UBDocumentTreeModel::dropMimeData(const QMimeData *data, Qt::DropAction act
             int fromIndex = sourceItem.sceneIndex();
             int toIndex = targetDocProxy->pageCount();
 
-            UBPersistenceManager::persistenceManager()->copyDocumentScene(fromProxy, fromIndex,
-                                                                          targetDocProxy, toIndex);
+            if (UBPersistenceManager::persistenceManager()->copyDocumentScene(fromProxy, fromIndex,
+                                                                              targetDocProxy, toIndex))
+                total++;
         }
 
         QApplication::restoreOverrideCursor();
@@ -2535,9 +2535,13 @@ void UBDocumentController::duplicateSelectedItem()
         if (selectedSceneIndexes.count() > 0)
         {
             int offset = 0;
+            int sceneCount = 0;
             foreach(int sceneIndex, selectedSceneIndexes)
             {
-                UBPersistenceManager::persistenceManager()->duplicateDocumentScene(selectedDocument(), sceneIndex + offset);
+                if (!UBPersistenceManager::persistenceManager()->duplicateDocumentScene(selectedDocument(), sceneIndex + offset))
+                    continue;
+
+                sceneCount++;
                 insertThumbPage(sceneIndex + offset);
                 if (selectedDocument() == mBoardController->selectedDocument())
                     emit mBoardController->addThumbnailRequired(selectedDocument(), sceneIndex + offset);
@@ -2550,9 +2554,8 @@ void UBDocumentController::duplicateSelectedItem()
             QDateTime now = QDateTime::currentDateTime();
             selectedDocument()->setMetaData(UBSettings::documentUpdatedAt, UBStringUtils::toUtcIsoDateTime(now));
             UBMetadataDcSubsetAdaptor::persist(selectedDocument());
-            int selectedThumbnailIndex = selectedSceneIndexes.last() + selectedSceneIndexes.size();
+            int selectedThumbnailIndex = selectedSceneIndexes.last() + offset;
             mDocumentUI->thumbnailWidget->selectItemAt(selectedThumbnailIndex);
-            int sceneCount = selectedSceneIndexes.count();
             UBApplication::showMessage(tr("duplicated %1 page","duplicated %1 pages",sceneCount).arg(sceneCount), false);
         }
     }
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include "UBBackgroundRenderer.h"
+
+#include <QPixmapCache>
+
+#include "core/memcheck.h"
+
+namespace
+{
+    // tiles are only used when a cell is small on the device, i.e. when there are many lines to draw
+    const qreal maxTiledCellPixels = 256;
+    // a tile holds several cells to limit the number of brush repetitions and the rounding of its size
+    const qreal minTilePixels = 128;
+}
+
+void UBBackgroundRenderer::draw(QPainter* painter, const QRectF& rect, Pattern pattern, qreal gridSize,
+                                bool intermediateLines, const QColor& color, const QPointF& origin)
+{
+    if (rect.isEmpty() || gridSize <= 0)
+        return;
+
+    QSizeF cell = cellSize(pattern, gridSize);
+
+    const QTransform& deviceTransform = painter->deviceTransform();
+    qreal pixelScale = qSqrt(deviceTransform.m11() * deviceTransform.m11() + deviceTransform.m12() * deviceTransform.m12());
+    qreal cellPixels = qMax(cell.width(), cell.height()) * pixelScale;
+
+    if (cellPixels < 1 || cellPixels > maxTiledCellPixels || !canUseTiles(painter))
+    {
+        painter->save();
+        painter->translate(origin);
+        drawLines(painter, rect.translated(-origin), pattern, gridSize, intermediateLines, color);
+        painter->restore();
+        return;
+    }
+
+    int cellsPerTile = qMax(1, qCeil(minTilePixels / cellPixels));
+    QSizeF tileSize = cell * cellsPerTile;
+    QSize tilePixels(qMax(1, qRound(tileSize.width() * pixelScale)), qMax(1, qRound(tileSize.height() * pixelScale)));
+
+    QString key = QString("UBBackground-%1-%2-%3-%4-%5-%6x%7")
+            .arg(pattern)
+            .arg(painter->testRenderHint(QPainter::Antialiasing))
+            .arg(gridSize)
+            .arg(intermediateLines)
+            .arg(color.rgba(), 0, 16)
+            .arg(tilePixels.width())
+            .arg(tilePixels.height());
+
+    QPixmap tile;
+
+    if (!QPixmapCache::find(key, &tile))
+    {
+        tile = QPixmap(tilePixels);
+        tile.fill(Qt::transparent);
+
+        QPainter tilePainter(&tile);
+        tilePainter.setRenderHints(painter->renderHints());
+        tilePainter.scale(tilePixels.width() / tileSize.width(), tilePixels.height() / tileSize.height());
+
+        // draw one cell beyond each border, so lines sitting on the tile border are complete once tiled
+        drawLines(&tilePainter, QRectF(-cell.width(), -cell.height(), tileSize.width() + 2 * cell.width(), tileSize.height() + 2 * cell.height()),
+                  pattern, gridSize, intermediateLines, color);
+        tilePainter.end();
+
+        QPixmapCache::insert(key, tile);
+    }
+
+    QTransform brushTransform;
+    brushTransform.translate(origin.x(), origin.y());
+    brushTransform.scale(tileSize.width() / tilePixels.width(), tileSize.height() / tilePixels.height());
+
+    QBrush brush(tile);
+    brush.setTransform(brushTransform);
+
+    painter->save();
+    // the tile size is rounded to whole pixels, smooth the residual scaling so no line gets dropped
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->fillRect(rect, brush);
+    painter->restore();
+}
+
+QPen UBBackgroundRenderer::seyesMarginPen()
+{
+    QPen redLineMargin(QColor("red"));
+    redLineMargin.setWidthF(2.);
+
+    return redLineMargin;
+}
+
+QSizeF UBBackgroundRenderer::cellSize(Pattern pattern, qreal gridSize)
+{
+    if (pattern == SeyesHorizontal || pattern == Seyes)
+        return QSizeF(gridSize * 2, gridSize * 2); // The grid size must be bigger
+
+    return QSizeF(gridSize, gridSize);
+}
+
+void UBBackgroundRenderer::drawLines(QPainter* painter, const QRectF& rect, Pattern pattern, qreal gridSize,
+                                     bool intermediateLines, const QColor& color)
+{
+    if (pattern == Crossed)
+    {
+        painter->setPen (color);
+
+        qreal firstY = ((int) (rect.y () / gridSize)) * gridSize;
+
+        for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSize)
+        {
+            painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+        }
+
+        qreal firstX = ((int) (rect.x () / gridSize)) * gridSize;
+
+        for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSize)
+        {
+            painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
+        }
+
+        if (intermediateLines)
+        {
+            QColor intermediateColor = color;
+            intermediateColor.setAlphaF(0.5 * color.alphaF());
+            painter->setPen(intermediateColor);
+
+            for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
+            {
+                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+            }
+
+            for (qreal xPos = firstX - gridSize/2; xPos < rect.x () + rect.width (); xPos += gridSize)
+            {
+                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
+            }
+        }
+    }
+    else if (pattern == Ruled)
+    {
+        painter->setPen (color);
+
+        qreal firstY = ((int) (rect.y () / gridSize)) * gridSize;
+
+        for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSize)
+        {
+            painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+        }
+
+        if (intermediateLines) {
+            QColor intermediateColor = color;
+            intermediateColor.setAlphaF(0.5 * color.alphaF());
+            painter->setPen(intermediateColor);
+
+            for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
+            {
+                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+            }
+        }
+    }
+    else
+    {
+        qreal gridSizeSeyes = gridSize * 2;
+
+        QPen seyesSquare ("#8e7cc3");
+        seyesSquare.setWidthF (2.);
+
+        QColor interlineColor("#6fa8dc");
+        interlineColor.setAlphaF(0.6);
+        QPen interlinePen(interlineColor);
+        interlinePen.setWidthF(2.);
+
+        // Horizontal lines
+
+        qreal firstY = ((int) (rect.y () / gridSizeSeyes)) * gridSizeSeyes;
+
+        for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSizeSeyes)
+        {
+            painter->setPen (seyesSquare);
+            painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
+            painter->setPen (interlinePen);
+            painter->drawLine (rect.x (), yPos+gridSizeSeyes/4, rect.x () + rect.width (), yPos+gridSizeSeyes/4);
+            painter->drawLine (rect.x (), yPos+2*gridSizeSeyes/4, rect.x () + rect.width (), yPos+2*gridSizeSeyes/4);
+            painter->drawLine (rect.x (), yPos+3*gridSizeSeyes/4, rect.x () + rect.width (), yPos+3*gridSizeSeyes/4);
+        }
+
+        // Vertical lines
+
+        if (pattern == Seyes)
+        {
+            qreal firstX = qCeil(rect.x () / gridSizeSeyes) * gridSizeSeyes;
+
+            painter->setPen (seyesSquare);
+            for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSizeSeyes)
+            {
+                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
+            }
+        }
+    }
+}
+
+bool UBBackgroundRenderer::canUseTiles(QPainter* painter)
+{
+    // pixmaps and the pixmap cache are only available in the GUI thread
+    if (QThread::currentThread() != QCoreApplication::instance()->thread())
+        return false;
+
+    QPaintEngine* engine = painter->paintEngine();
+
+    if (!engine)
+        return false;
+
+    // keep vector output for printing and PDF export
+    return engine->type() == QPaintEngine::Raster
+            || engine->type() == QPaintEngine::OpenGL
+            || engine->type() == QPaintEngine::OpenGL2;
+}
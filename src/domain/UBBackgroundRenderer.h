@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef UBBACKGROUNDRENDERER_H
+#define UBBACKGROUNDRENDERER_H
+
+#include <QtGui>
+
+/**
+ * Draws the line patterns of the page backgrounds. On raster devices the pattern is rendered once
+ * into a tile for the current device resolution, kept in the pixmap cache and used as a brush
+ * to fill the exposed area, so the control view, the display view and the thumbnails share the
+ * same tiles. Printers and PDF export still get the individual lines.
+ */
+class UBBackgroundRenderer
+{
+    public:
+        enum Pattern
+        {
+            Crossed = 0,
+            Ruled,
+            SeyesHorizontal,    // the horizontal lines of the Seyes ruling only
+            Seyes
+        };
+
+        /**
+         * Fill rect with the pattern. Lines are aligned on the multiples of the cell size of the
+         * pattern, starting from origin (in scene coordinates).
+         */
+        static void draw(QPainter* painter, const QRectF& rect, Pattern pattern, qreal gridSize,
+                         bool intermediateLines, const QColor& color, const QPointF& origin = QPointF());
+
+        static QPen seyesMarginPen();
+
+    private:
+        UBBackgroundRenderer() {}
+
+        static QSizeF cellSize(Pattern pattern, qreal gridSize);
+        static void drawLines(QPainter* painter, const QRectF& rect, Pattern pattern, qreal gridSize,
+                              bool intermediateLines, const QColor& color);
+        static bool canUseTiles(QPainter* painter);
+};
+
+#endif // UBBACKGROUNDRENDERER_H
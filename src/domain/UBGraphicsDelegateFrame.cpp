@@ -46,6 +46,13 @@
 
 #include "core/memcheck.h"
 
+QGraphicsSvgItem* UBGraphicsDelegateFrame::createSvgItem(const QString& fileName)
+{
+    QGraphicsSvgItem* item = new QGraphicsSvgItem(this);
+    item->setSharedRenderer(DelegateButton::sharedRenderer(fileName));
+    return item;
+}
+
 UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelegate, QRectF pRect, qreal pFrameWidth, bool respectRatio, bool hasTitleBar)
     : QGraphicsRectItem(), QObject(pDelegate)
     , mCurrentTool(None)
@@ -101,7 +108,7 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     if (mDelegate->testUBFlags(GF_SCALABLE_X_AXIS) && mDelegate->testUBFlags(GF_SCALABLE_Y_AXIS))
     {
         mHasBottomRightResizeGrip = true;
-        mBottomRightResizeGripSvgItem = new QGraphicsSvgItem(":/images/resize.svg", this);
+        mBottomRightResizeGripSvgItem = createSvgItem(":/images/resize.svg");
         mBottomRightResizeGrip = new QGraphicsRectItem(this);
         mBottomRightResizeGrip->setPen(Qt::NoPen);
     }
@@ -109,7 +116,7 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     if (mDelegate->testUBFlags(GF_SCALABLE_Y_AXIS))
     {
         mHasBottomResizeGrip = true;
-        mBottomResizeGripSvgItem = new QGraphicsSvgItem(":/images/resizeBottom.svg", this);
+        mBottomResizeGripSvgItem = createSvgItem(":/images/resizeBottom.svg");
         mBottomResizeGrip = new QGraphicsRectItem(this);
         mBottomResizeGrip->setPen(Qt::NoPen);
     }
@@ -117,7 +124,7 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     if (mDelegate->testUBFlags(GF_SCALABLE_X_AXIS))
     {
         mHasLeftResizeGrip = true;
-        mLeftResizeGripSvgItem = new QGraphicsSvgItem(":/images/resizeLeft.svg", this);
+        mLeftResizeGripSvgItem = createSvgItem(":/images/resizeLeft.svg");
         mLeftResizeGrip = new QGraphicsRectItem(this);
         mLeftResizeGrip->setPen(Qt::NoPen);
     }
@@ -125,7 +132,7 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     if (mDelegate->testUBFlags(GF_SCALABLE_X_AXIS))
     {
         mHasRightResizeGrip = true;
-        mRightResizeGripSvgItem = new QGraphicsSvgItem(":/images/resizeRight.svg", this);
+        mRightResizeGripSvgItem = createSvgItem(":/images/resizeRight.svg");
         mRightResizeGrip = new QGraphicsRectItem(this);
         mRightResizeGrip->setPen(Qt::NoPen);
     }
@@ -133,12 +140,12 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     if (mDelegate->testUBFlags(GF_SCALABLE_Y_AXIS))
     {
         mHasTopResizeGrip = true;
-        mTopResizeGripSvgItem = new QGraphicsSvgItem(":/images/resizeTop.svg", this);
+        mTopResizeGripSvgItem = createSvgItem(":/images/resizeTop.svg");
         mTopResizeGrip = new QGraphicsRectItem(this);
         mTopResizeGrip->setPen(Qt::NoPen);
     }
 
-    mRotateButton = new QGraphicsSvgItem(":/images/rotate.svg", this);
+    mRotateButton = createSvgItem(":/images/rotate.svg");
     mRotateButton->setCursor(UBResources::resources()->rotateCursor);
     mRotateButton->setVisible(mDelegate->testUBFlags(GF_REVOLVABLE));
 
@@ -896,11 +903,14 @@ void UBGraphicsDelegateFrame::positionHandles()
         setRect(center.x() - width / 2, center.y() - h / 2, width, h);
     }
 
-    resetTransform();
-    setTransform(QTransform::fromTranslate(center.x(), center.y()), true);
-    setTransform(QTransform().rotate(-angle), true);
-    setTransform(QTransform::fromTranslate(-center.x(), -center.y()), true);
-    //TODO: combine these transforms into one
+    // set the rotation around the center in one step, each setTransform invalidates the frame and its handles
+    QTransform frameTransform;
+    frameTransform.translate(center.x(), center.y());
+    frameTransform.rotate(-angle);
+    frameTransform.translate(-center.x(), -center.y());
+
+    if (transform() != frameTransform)
+        setTransform(frameTransform);
 
     QVariant vLocked = delegated()->data(UBGraphicsItemData::ItemLocked);
     bool isLocked = (vLocked.isValid() && vLocked.toBool());
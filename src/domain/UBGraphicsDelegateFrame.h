@@ -70,6 +70,8 @@ class UBGraphicsDelegateFrame: public QGraphicsRectItem, public QObject
         QList<UBGraphicsDelegateFrame *> getLinkedFrames();
 
     private:
+        QGraphicsSvgItem* createSvgItem(const QString& fileName);
+
         QRectF bottomRightResizeGripRect() const;
         QRectF bottomResizeGripRect() const;
         QRectF leftResizeGripRect() const;
@@ -240,7 +240,8 @@ void UBGraphicsGroupContainerItem::copyItemParameters(UBItem *copy) const
         cp->setFlag(QGraphicsItem::ItemIsSelectable, true);
         cp->setData(UBGraphicsItemData::ItemLayerType, this->data(UBGraphicsItemData::ItemLayerType));
         cp->setData(UBGraphicsItemData::ItemLocked, this->data(UBGraphicsItemData::ItemLocked));
-        cp->setData(UBGraphicsItemData::ItemOwnZValue, this->data(UBGraphicsItemData::ItemOwnZValue));
+        // a group created by the scene is already in its z index
+        UBGraphicsItem::assignZValue(cp, this->data(UBGraphicsItemData::ItemOwnZValue).toReal());
         cp->setZValue(this->zValue());
     }
 }
@@ -63,7 +63,7 @@
 #include "core/memcheck.h"
 
 DelegateButton::DelegateButton(const QString & fileName, QGraphicsItem* pDelegated, QGraphicsItem * parent, Qt::WindowFrameSection section)
-    : QGraphicsSvgItem(fileName, parent)
+    : QGraphicsSvgItem(parent)
     , mDelegated(pDelegated)
     , mIsTransparentToMouseEvent(false)
     , mIsPressed(false)
@@ -72,6 +72,7 @@ DelegateButton::DelegateButton(const QString & fileName, QGraphicsItem* pDelegat
     , mShowProgressIndicator(false)
     , mButtonAlignmentSection(section)
 {
+    setFileName(fileName);
     setAcceptedMouseButtons(Qt::LeftButton);
     setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Control));
     setCacheMode(QGraphicsItem::NoCache); /* because of SANKORE-1017: this allows pixmap to be refreshed when grabbing window, thus teacher screen is synchronized with main screen. */
@@ -82,9 +83,50 @@ DelegateButton::~DelegateButton()
     // NOOP
 }
 
+QSvgRenderer* DelegateButton::sharedRenderer(const QString& fileName)
+{
+    static QHash<QString, QSvgRenderer*> renderers;
+
+    QSvgRenderer* renderer = renderers.value(fileName);
+
+    if (!renderer)
+    {
+        // lives as long as the application, the icons are used on every page
+        renderer = new QSvgRenderer(fileName, QCoreApplication::instance());
+        renderers.insert(fileName, renderer);
+    }
+
+    return renderer;
+}
+
 void DelegateButton::setFileName(const QString & fileName)
 {
-    QGraphicsSvgItem::setSharedRenderer(new QSvgRenderer (fileName, this));
+    QGraphicsSvgItem::setSharedRenderer(sharedRenderer(fileName));
+}
+
+QPixmap DelegateButton::iconPixmap(const QSize& pixelSize) const
+{
+    // shared renderers are never deleted, so their address identifies the icon
+    QString key = QString("UBDelegateButton-%1-%2x%3")
+            .arg(reinterpret_cast<quintptr>(renderer()))
+            .arg(pixelSize.width())
+            .arg(pixelSize.height());
+
+    QPixmap icon;
+
+    if (!QPixmapCache::find(key, &icon))
+    {
+        icon = QPixmap(pixelSize);
+        icon.fill(Qt::transparent);
+
+        QPainter painter(&icon);
+        renderer()->render(&painter);
+        painter.end();
+
+        QPixmapCache::insert(key, icon);
+    }
+
+    return icon;
 }
 
 void DelegateButton::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -124,9 +166,18 @@ void DelegateButton::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 void DelegateButton::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
+    QRectF bounds = boundingRect();
+    qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    QSize pixelSize = (painter->deviceTransform().mapRect(bounds).size() * devicePixelRatio).toSize();
+
     painter->save();
     painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
-    QGraphicsSvgItem::paint(painter, option, widget);
+
+    if (pixelSize.isEmpty())
+        QGraphicsSvgItem::paint(painter, option, widget);
+    else
+        painter->drawPixmap(bounds, iconPixmap(pixelSize), QRectF(QPointF(0, 0), pixelSize));
+
     painter->restore();
 
     if (mIsPressed && mShowProgressIndicator) {
@@ -175,7 +226,6 @@ UBGraphicsItemDelegate::UBGraphicsItemDelegate(QGraphicsItem* pDelegated, QObjec
     , mFrameWidth(UBSettings::settings()->objectFrameWidth)
     , mAntiScaleRatio(1.0)
     , mToolBarItem(NULL)
-    , mMimeData(NULL)
     , mHideOnDisplayWhenSelectedAction(nullptr)
 #ifdef DEBUG_Z_LEVEL
     , mZLevelTextItem(nullptr)
@@ -278,8 +328,6 @@ UBGraphicsItemDelegate::~UBGraphicsItemDelegate()
             disconnect(scene, &UBGraphicsScene::zoomChanged, this, &UBGraphicsItemDelegate::onZoomChanged);
         }
     }
-    // do not release mMimeData.
-    // the mMimeData is owned by QDrag since the setMimeData call as specified in the documentation
 }
 
 
@@ -309,10 +357,18 @@ QVariant UBGraphicsItemDelegate::itemChange(QGraphicsItem::GraphicsItemChange ch
             }
             break;
         }
+        case QGraphicsItem::ItemSceneHasChanged :
+        {
+            UBGraphicsScene::itemSceneHasChanged(delegated());
+            break;
+        }
         case QGraphicsItem::ItemVisibleHasChanged :
         {
             bool shownOnDisplay = mDelegated->data(UBGraphicsItemData::ItemLayerType).toInt() != UBItemLayerType::Control;
             showHide(shownOnDisplay);
+
+            if (ubScene && ubScene->isBackgroundObject(delegated()))
+                ubScene->invalidateBackgroundObject();
             break;
         }
         case QGraphicsItem::ItemPositionHasChanged :
@@ -322,6 +378,9 @@ QVariant UBGraphicsItemDelegate::itemChange(QGraphicsItem::GraphicsItemChange ch
             if (ubScene)
             {
                 ubScene->setModified(true);
+
+                if (ubScene->isBackgroundObject(delegated()))
+                    ubScene->invalidateBackgroundObject();
             }
 
             if (controlsExist())
@@ -395,25 +454,28 @@ bool UBGraphicsItemDelegate::mousePressEvent(QGraphicsSceneMouseEvent *event)
     }
 }
 
-void UBGraphicsItemDelegate::setMimeData(QMimeData *mimeData)
-{
-    mMimeData = mimeData;
-}
-
 bool UBGraphicsItemDelegate::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
-    if(mMimeData) {
-        QDrag* mDrag = new QDrag(event->widget());
-        mDrag->setMimeData(mMimeData);
-        if (!mDragPixmap.isNull()) {
-            mDrag->setPixmap(mDragPixmap);
-            mDrag->setHotSpot(mDragPixmap.rect().center());
-        }
-        mDrag->exec();
-        mDragPixmap = QPixmap();
+    UBGraphicsItem* item = dynamic_cast<UBGraphicsItem*>(delegated());
+
+    if (!item || !item->isDragSource())
+        return false;
+
+    // a click must not pay for the payload, it is only built when the drag really starts
+    if ((event->pos() - mDragStartPosition).manhattanLength() < QApplication::startDragDistance())
         return true;
+
+    QDrag* mDrag = new QDrag(event->widget());
+    mDrag->setMimeData(item->dragMimeData()); // owned by QDrag
+
+    QPixmap dragPixmap = item->dragPixmap();
+    if (!dragPixmap.isNull()) {
+        mDrag->setPixmap(dragPixmap);
+        mDrag->setHotSpot(dragPixmap.rect().center());
     }
-    return false;
+
+    mDrag->exec();
+    return true;
 }
 
 bool UBGraphicsItemDelegate::wheelEvent(QGraphicsSceneWheelEvent *event)
@@ -995,6 +1057,7 @@ UBGraphicsToolBarItem::UBGraphicsToolBarItem(QGraphicsItem * parent) :
     rect.setWidth(parent->boundingRect().width());
     this->setRect(rect);
 
+    setBrush(QBrush(UBSettings::paletteColor));
     setPen(Qt::NoPen);
     hide();
 
@@ -1026,8 +1089,6 @@ void UBGraphicsToolBarItem::paint(QPainter *painter, const QStyleOptionGraphicsI
     QPainterPath path;
     path.addRoundedRect(rect(), 10, 10);
 
-    setBrush(QBrush(UBSettings::paletteColor));
-
     painter->fillPath(path, brush());
 }
 
@@ -80,6 +80,11 @@ class DelegateButton: public QGraphicsSvgItem
         void setSection(Qt::WindowFrameSection section) {mButtonAlignmentSection =  section;}
         Qt::WindowFrameSection getSection() const {return mButtonAlignmentSection;}
 
+        /**
+         * Renderer of an icon resource, parsed once and shared by all the controls showing it.
+         */
+        static QSvgRenderer* sharedRenderer(const QString& fileName);
+
     protected:
 
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -94,6 +99,8 @@ private slots:
 
     private:
 
+        QPixmap iconPixmap(const QSize& pixelSize) const;
+
         QGraphicsItem* mDelegated;
 
         QTime mPressedTime;
@@ -282,10 +289,6 @@ class UBGraphicsItemDelegate : public QObject
 
         bool isLocked() const;
 
-        QMimeData* mimeData(){ return mMimeData; }
-        void setMimeData(QMimeData* mimeData);
-        void setDragPixmap(const QPixmap &pix) {mDragPixmap = pix;}
-
         void setLocked(bool pLocked);
         void setButtonsVisible(bool visible);
 
@@ -378,8 +381,6 @@ private:
         QPointF mDragStartPosition;
         qreal mPreviousZValue;
         QSizeF mPreviousSize;
-        QMimeData* mMimeData;
-        QPixmap mDragPixmap;
 
         bool mMoved;
         UBGraphicsFlags mFlags;
@@ -41,6 +41,9 @@
 #include "domain/UBGraphicsGroupContainerItem.h"
 #include "domain/UBGraphicsPolygonItem.h"
 
+// above this number of items, the scene index is suspended during undo and redo
+static const int sBulkChangeThreshold = 256;
+
 UBGraphicsItemUndoCommand::UBGraphicsItemUndoCommand(std::shared_ptr<UBGraphicsScene> pScene, const QSet<QGraphicsItem*>& pRemovedItems, const QSet<QGraphicsItem*>& pAddedItems, const GroupDataTable &groupsMap): UBUndoCommand()
     , mScene(pScene)
     , mRemovedItems(pRemovedItems - pAddedItems)
@@ -91,92 +94,29 @@ void UBGraphicsItemUndoCommand::undo()
         return;
     }
 
-    QSetIterator<QGraphicsItem*> itAdded(mAddedItems);
-    while (itAdded.hasNext())
-    {
-        QGraphicsItem* item = itAdded.next();
+    const bool bulkChange = isBulkChange();
 
-        UBApplication::boardController->freezeW3CWidget(item, true);
-        item->setSelected(false);
-
-        QTransform t;
-        bool bApplyTransform = false;
-        UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
-        if (polygonItem){
-            if (polygonItem->strokesGroup()
-                    && polygonItem->strokesGroup()->parentItem()
-                    && UBGraphicsGroupContainerItem::Type == polygonItem->strokesGroup()->parentItem()->type())
-            {
-                bApplyTransform = true;
-                t = polygonItem->sceneTransform();
-            }
-            else if (polygonItem->strokesGroup())
-                polygonItem->resetTransform();
-
-            polygonItem->strokesGroup()->removeFromGroup(polygonItem);
-        }
-        mScene->removeItem(item);
-
-        if (bApplyTransform)
-            polygonItem->setTransform(t);
+    if (bulkChange)
+        mScene->beginBulkChange();
 
+    foreach (QGraphicsItem* item, mAddedItems)
+    {
+        UBApplication::boardController->freezeW3CWidget(item, true);
+        detachItem(item, false);
     }
 
-    QSetIterator<QGraphicsItem*> itRemoved(mRemovedItems);
-    while (itRemoved.hasNext())
+    foreach (QGraphicsItem* item, mRemovedItems)
     {
-        QGraphicsItem* item = itRemoved.next();
         if (item)
-        {
-            if (itemLayerType::BackgroundItem == item->data(UBGraphicsItemData::itemLayerType))
-                mScene->setAsBackgroundObject(item);
-            else
-                mScene->addItem(item);
-
-            if (UBGraphicsPolygonItem::Type == item->type())
-            {
-                UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
-                if (polygonItem)
-                {
-                    mScene->removeItem(polygonItem);
-                    mScene->removeItemFromDeletion(polygonItem);
-                    polygonItem->strokesGroup()->addToGroup(polygonItem);
-                }
-            }
-
-            UBApplication::boardController->freezeW3CWidget(item, false);
-        }
+            attachItem(item, itemLayerType::BackgroundItem == item->data(UBGraphicsItemData::itemLayerType));
     }
 
-    GroupDataTableIterator curMapElement(mExcludedFromGroup);
-    UBGraphicsGroupContainerItem *nextGroup = NULL;
-    UBGraphicsGroupContainerItem *previousGroupItem = NULL;
-    bool groupChanged = false;
-
-    while (curMapElement.hasNext()) {
-        curMapElement.next();
-
-        groupChanged = previousGroupItem != curMapElement.key();
-        //trying to find the group on the scene;
-        if (!nextGroup || groupChanged) {
-            UBGraphicsGroupContainerItem *groupCandidate = curMapElement.key();
-            if (groupCandidate) {
-                nextGroup = groupCandidate;
-                if(!mScene->items().contains(nextGroup)) {
-                    mScene->addItem(nextGroup);
-                }
-                nextGroup->setVisible(true);
-            }
-        }
+    restoreGroups();
 
-        QGraphicsItem *groupedItem = mScene->itemForUuid(curMapElement.value());
-        if (groupedItem) {
-            nextGroup->addToGroup(groupedItem);
-        }
+    if (bulkChange)
+        mScene->endBulkChange();
 
-        previousGroupItem = curMapElement.key();
-        UBGraphicsItem::Delegate(nextGroup)->update();
-    }
+    mScene->setModified(true);
 
     // force refresh, QT is a bit lazy and take a lot of time (nb item ^2 ?) to trigger repaint
     mScene->update(mScene->sceneRect());
@@ -194,98 +134,151 @@ void UBGraphicsItemUndoCommand::redo()
             return;
         }
 
-        GroupDataTableIterator curMapElement(mExcludedFromGroup);
-        UBGraphicsGroupContainerItem *nextGroup = NULL;
-        UBGraphicsGroupContainerItem *previousGroupItem = NULL;
-        bool groupChanged = false;
+        const bool bulkChange = isBulkChange();
 
-        while (curMapElement.hasNext()) {
-            curMapElement.next();
+        if (bulkChange)
+            mScene->beginBulkChange();
 
-            groupChanged = previousGroupItem != curMapElement.key();
-            //trying to find the group on the scene;
-            if (!nextGroup || groupChanged) {
-                UBGraphicsGroupContainerItem *groupCandidate = curMapElement.key();
-                if (groupCandidate) {
-                    nextGroup = groupCandidate;
-                }
-            }
-            QGraphicsItem *groupedItem = mScene->itemForUuid(curMapElement.value());
-            if (groupedItem) {
-                if (nextGroup->childItems().count() == 1) {
-                    nextGroup->destroy(false);
-                    break;
-                }
-                nextGroup->removeFromGroup(groupedItem);
-            }
+        excludeFromGroups();
 
-            previousGroupItem = curMapElement.key();
-            UBGraphicsItem::Delegate(nextGroup)->update();
+        foreach (QGraphicsItem* item, mRemovedItems)
+        {
+            detachItem(item, itemLayerType::BackgroundItem == item->data(UBGraphicsItemData::itemLayerType));
+            UBApplication::boardController->freezeW3CWidget(item, true);
         }
 
-        QSetIterator<QGraphicsItem*> itRemoved(mRemovedItems);
-        while (itRemoved.hasNext())
+        foreach (QGraphicsItem* item, mAddedItems)
         {
-            QGraphicsItem* item = itRemoved.next();
-            item->setSelected(false);
+            if (item)
+                attachItem(item, UBItemLayerType::FixedBackground == item->data(UBGraphicsItemData::ItemLayerType));
+        }
 
-            QTransform t;
-            bool bApplyTransform = false;
-            UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+        if (bulkChange)
+            mScene->endBulkChange();
 
-            if (polygonItem){
-                if(polygonItem->strokesGroup()
-                        && polygonItem->strokesGroup()->parentItem()
-                        && UBGraphicsGroupContainerItem::Type == polygonItem->strokesGroup()->parentItem()->type())
-                {
-                    bApplyTransform = true;
-                    t = polygonItem->sceneTransform();
-                }
-                else if (polygonItem->strokesGroup())
-                    polygonItem->resetTransform();
+        mScene->setModified(true);
 
-                polygonItem->strokesGroup()->removeFromGroup(polygonItem);
-            }
+        // force refresh, QT is a bit lazy and take a lot of time (nb item ^2) to trigger repaint
+        mScene->update(mScene->sceneRect());
+    }
+    else
+    {
+        mFirstRedo = false;
+    }
+}
+
+bool UBGraphicsItemUndoCommand::isBulkChange() const
+{
+    return mRemovedItems.size() + mAddedItems.size() + mExcludedFromGroup.size() >= sBulkChangeThreshold;
+}
 
-            if (itemLayerType::BackgroundItem == item->data(UBGraphicsItemData::itemLayerType))
-                mScene->setAsBackgroundObject(nullptr);
-            else
-                mScene->removeItem(item);
+void UBGraphicsItemUndoCommand::detachItem(QGraphicsItem* item, bool isBackground)
+{
+    item->setSelected(false);
 
-            if (bApplyTransform)
-                item->setTransform(t);
+    QTransform t;
+    bool bApplyTransform = false;
+    UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
 
-            UBApplication::boardController->freezeW3CWidget(item, true);
+    if (polygonItem && polygonItem->strokesGroup())
+    {
+        if (polygonItem->strokesGroup()->parentItem()
+                && UBGraphicsGroupContainerItem::Type == polygonItem->strokesGroup()->parentItem()->type())
+        {
+            bApplyTransform = true;
+            t = polygonItem->sceneTransform();
         }
+        else
+            polygonItem->resetTransform();
+
+        polygonItem->strokesGroup()->removeFromGroup(polygonItem);
+    }
+
+    if (isBackground)
+        mScene->setAsBackgroundObject(nullptr);
+    else
+        mScene->removeItem(item);
+
+    if (bApplyTransform)
+        item->setTransform(t);
+}
+
+void UBGraphicsItemUndoCommand::attachItem(QGraphicsItem* item, bool isBackground)
+{
+    UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+
+    if (polygonItem && polygonItem->strokesGroup())
+    {
+        // polygons are never top-level items: put them back into their stroke directly
+        // instead of adding them to the scene and removing them again
+        mScene->removeItemFromDeletion(polygonItem);
+        polygonItem->strokesGroup()->addToGroup(polygonItem);
+    }
+    else if (isBackground)
+        mScene->setAsBackgroundObject(item);
+    else
+        mScene->addItem(item);
+
+    UBApplication::boardController->freezeW3CWidget(item, false);
+}
+
+void UBGraphicsItemUndoCommand::restoreGroups()
+{
+    if (mExcludedFromGroup.isEmpty())
+        return;
+
+    foreach (UBGraphicsGroupContainerItem* group, mExcludedFromGroup.uniqueKeys())
+    {
+        if (!group)
+            continue;
 
-        QSetIterator<QGraphicsItem*> itAdded(mAddedItems);
-        while (itAdded.hasNext())
+        if (group->scene() != mScene.get())
+            mScene->addItem(group);
+
+        group->setVisible(true);
+
+        foreach (const QUuid& uuid, mExcludedFromGroup.values(group))
         {
-            QGraphicsItem* item = itAdded.next();
-            if (item)
-            {
-                UBApplication::boardController->freezeW3CWidget(item, false);
+            QGraphicsItem* groupedItem = mScene->itemForUuid(uuid);
 
-                if (UBItemLayerType::FixedBackground == item->data(UBGraphicsItemData::ItemLayerType))
-                    mScene->setAsBackgroundObject(item);
-                else
-                    mScene->addItem(item);
+            if (groupedItem)
+                group->addToGroup(groupedItem);
+        }
+
+        UBGraphicsItem::Delegate(group)->update();
+    }
+}
+
+void UBGraphicsItemUndoCommand::excludeFromGroups()
+{
+    if (mExcludedFromGroup.isEmpty())
+        return;
+
+    foreach (UBGraphicsGroupContainerItem* group, mExcludedFromGroup.uniqueKeys())
+    {
+        if (!group)
+            continue;
 
-                UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
-                if (polygonItem)
+        bool destroyed = false;
+
+        foreach (const QUuid& uuid, mExcludedFromGroup.values(group))
+        {
+            QGraphicsItem* groupedItem = mScene->itemForUuid(uuid);
+
+            if (groupedItem)
+            {
+                if (group->childItems().count() == 1)
                 {
-                    mScene->removeItem(polygonItem);
-                    mScene->removeItemFromDeletion(polygonItem);
-                    polygonItem->strokesGroup()->addToGroup(polygonItem);
+                    group->destroy(false);
+                    destroyed = true;
+                    break;
                 }
+
+                group->removeFromGroup(groupedItem);
             }
         }
 
-        // force refresh, QT is a bit lazy and take a lot of time (nb item ^2) to trigger repaint
-        mScene->update(mScene->sceneRect());
-    }
-    else
-    {
-        mFirstRedo = false;
+        if (!destroyed)
+            UBGraphicsItem::Delegate(group)->update();
     }
 }
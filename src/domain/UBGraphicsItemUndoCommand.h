@@ -62,11 +62,14 @@ class UBGraphicsItemUndoCommand : public UBUndoCommand
         virtual void redo();
 
     private:
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        typedef QMultiMapIterator<UBGraphicsGroupContainerItem*, QUuid> GroupDataTableIterator;
-#else
-        typedef QMapIterator<UBGraphicsGroupContainerItem*, QUuid> GroupDataTableIterator;
-#endif
+        bool isBulkChange() const;
+
+        void detachItem(QGraphicsItem* item, bool isBackground);
+        void attachItem(QGraphicsItem* item, bool isBackground);
+
+        void restoreGroups();
+        void excludeFromGroups();
+
         std::shared_ptr<UBGraphicsScene> mScene;
         QSet<QGraphicsItem*> mRemovedItems;
         QSet<QGraphicsItem*> mAddedItems;
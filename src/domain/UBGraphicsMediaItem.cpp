@@ -34,10 +34,17 @@
 #include "UBGraphicsDelegateFrame.h"
 #include "document/UBDocumentProxy.h"
 #include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
 #include "board/UBBoardController.h"
 #include "core/memcheck.h"
 
 #include <QGraphicsVideoItem>
+#include <QPixmapCache>
+#include <QtConcurrent>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <QVideoSink>
+#endif
 
 bool UBGraphicsMediaItem::sIsMutedByDefault = false;
 
@@ -72,25 +79,46 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
         , mMediaFileUrl(pMediaFileUrl)
         , mLinkedImage(NULL)
         , mInitialPos(0)
+        , mDuration(0)
 {
 
     mErrorString = "";
 
+    mMediaObject = nullptr;
+
+    setDelegate(new UBGraphicsMediaItemDelegate(this));
+
+    setData(UBGraphicsItemData::itemLayerType, QVariant(itemLayerType::ObjectItem));
+    setFlag(ItemIsMovable, true);
+    setFlag(ItemSendsGeometryChanges, true);
+
+    connect(Delegate(), SIGNAL(showOnDisplayChanged(bool)),
+            this, SLOT(showOnDisplayChanged(bool)));
+}
+
+/**
+ * @brief Return the media player, creating it if needed.
+ */
+QMediaPlayer* UBGraphicsMediaItem::mediaPlayer()
+{
+    if (mMediaObject)
+        return mMediaObject;
+
     mMediaObject = new QMediaPlayer(this);
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    mMediaObject->setSource(pMediaFileUrl);
-    QAudioOutput* output = new QAudioOutput(QAudioDevice(), this);
+    mMediaObject->setSource(absoluteMediaFileUrl());
+    QAudioOutput* output = new QAudioOutput(QAudioDevice(), mMediaObject);
     mMediaObject->setAudioOutput(output);
 #else
-    mMediaObject->setMedia(pMediaFileUrl);
+    mMediaObject->setMedia(absoluteMediaFileUrl());
 #endif
 
-    setDelegate(new UBGraphicsMediaItemDelegate(this));
+    applyMute();
 
-    setData(UBGraphicsItemData::itemLayerType, QVariant(itemLayerType::ObjectItem));
-    setFlag(ItemIsMovable, true);
-    setFlag(ItemSendsGeometryChanges, true);
+    // connected first, so that the position is restored before the delegate handles the status
+    connect(mMediaObject, &QMediaPlayer::mediaStatusChanged,
+            this, &UBGraphicsMediaItem::mediaStatusChanged);
 
     connect(mMediaObject, SIGNAL(mediaStatusChanged(QMediaPlayer::MediaStatus)),
             Delegate(), SLOT(mediaStatusChanged(QMediaPlayer::MediaStatus)));
@@ -109,9 +137,6 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
     connect(mMediaObject, SIGNAL(durationChanged(qint64)),
             Delegate(), SLOT(totalTimeChanged(qint64)));
 
-    connect(Delegate(), SIGNAL(showOnDisplayChanged(bool)),
-            this, SLOT(showOnDisplayChanged(bool)));
-
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     connect(mMediaObject, &QMediaPlayer::errorOccurred,
             this, &UBGraphicsMediaItem::mediaError);
@@ -119,6 +144,69 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
     connect(mMediaObject, qOverload<QMediaPlayer::Error>(&QMediaPlayer::error),
             this, &UBGraphicsMediaItem::mediaError);
 #endif
+
+    setupMediaPlayer();
+
+    return mMediaObject;
+}
+
+void UBGraphicsMediaItem::setupMediaPlayer()
+{
+    //NOOP
+}
+
+/**
+ * @brief Delete the media player and release its decoder, keeping the position to resume from.
+ */
+void UBGraphicsMediaItem::releaseMediaPlayer()
+{
+    if (!mMediaObject)
+        return;
+
+    qint64 position = mMediaObject->position();
+    mDuration = mMediaObject->duration();
+
+    if (mStopped)
+        mInitialPos = 0;
+    else if (position > 0 && mDuration - position > 0)
+        mInitialPos = position;
+
+    // the signals emitted while stopping must not reach the delegate, they would reset the position
+    QMediaPlayer* player = mMediaObject;
+    mMediaObject = nullptr;
+
+    player->disconnect();
+    delete player;
+}
+
+bool UBGraphicsMediaItem::isOnActiveScene()
+{
+    return UBApplication::boardController
+            && scene()
+            && UBApplication::boardController->activeScene() == scene();
+}
+
+QUrl UBGraphicsMediaItem::absoluteMediaFileUrl()
+{
+    QString localFile = mMediaFileUrl.toLocalFile();
+
+    if (scene() && scene()->document()
+            && (localFile.startsWith("audios/") || localFile.startsWith("videos/")))
+        return QUrl::fromLocalFile(scene()->document()->persistencePath() + "/" + localFile);
+
+    return mMediaFileUrl;
+}
+
+void UBGraphicsMediaItem::applyMute()
+{
+    if (!mMediaObject)
+        return;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    mMediaObject->audioOutput()->setMuted(mMuted);
+#else
+    mMediaObject->setMuted(mMuted);
+#endif
 }
 
 UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsItem *parent)
@@ -131,7 +219,10 @@ UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsIte
 
     this->setSize(320, 26);
     this->setMinimumSize(QSize(150, 26));
+}
 
+void UBGraphicsAudioItem::setupMediaPlayer()
+{
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     mMediaObject->setNotifyInterval(1000);
 #endif
@@ -139,31 +230,40 @@ UBGraphicsAudioItem::UBGraphicsAudioItem(const QUrl &pMediaFileUrl, QGraphicsIte
 
 UBGraphicsVideoItem::UBGraphicsVideoItem(const QUrl &pMediaFileUrl, QGraphicsItem *parent)
     :UBGraphicsMediaItem(pMediaFileUrl, parent)
+    , mVideoItem(nullptr)
+    , mPlaceholderVisible(false)
+    , mPosterMissing(false)
 {
     haveLinkedImage = true;
     setPlaceholderVisible(true);
     Delegate()->createControls();
 
+    setMinimumSize(QSize(320, 240));
+    setSize(320, 240);
+
+    setAcceptHoverEvents(true);
+
+    update();
+}
+
+void UBGraphicsVideoItem::setupMediaPlayer()
+{
     mVideoItem = new QGraphicsVideoItem(this);
 
     mVideoItem->setData(UBGraphicsItemData::ItemLayerType, UBItemLayerType::Object);
     mVideoItem->setFlag(ItemStacksBehindParent, true);
+    mVideoItem->setSize(rect().size());
 
     /* setVideoOutput has to be called only when the video item is visible on the screen,
-     * due to a Qt bug (QTBUG-32522). So instead of calling it here, it is called when the
-     * active scene has changed, or when the item is first created.
-     * If and when Qt fix this issue, this should be changed back.
+     * due to a Qt bug (QTBUG-32522). The player is only created for the active scene or
+     * when playback is requested, so the item is visible at this point.
      * */
     mMediaObject->setVideoOutput(mVideoItem);
-    mHasVideoOutput = true;
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     mMediaObject->setNotifyInterval(50);
 #endif
 
-    setMinimumSize(QSize(320, 240));
-    setSize(320, 240);
-
     connect(mVideoItem, SIGNAL(nativeSizeChanged(QSizeF)),
             this, SLOT(videoSizeChanged(QSizeF)));
 
@@ -187,9 +287,27 @@ UBGraphicsVideoItem::UBGraphicsVideoItem(const QUrl &pMediaFileUrl, QGraphicsIte
             this, &UBGraphicsVideoItem::mediaError);
 #endif
 
-    setAcceptHoverEvents(true);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    // the first frame displayed becomes the poster, if the document doesn't have one yet
+    if (!posterPath().isEmpty() && !QFileInfo::exists(posterPath()))
+    {
+        connect(mVideoItem->videoSink(), &QVideoSink::videoFrameChanged,
+                this, &UBGraphicsVideoItem::videoFrameChanged);
+    }
+#endif
+}
 
-    update();
+void UBGraphicsVideoItem::releaseMediaPlayer()
+{
+    UBGraphicsMediaItem::releaseMediaPlayer();
+
+    if (mVideoItem)
+    {
+        delete mVideoItem;
+        mVideoItem = nullptr;
+    }
+
+    setPlaceholderVisible(true);
 }
 
 UBGraphicsMediaItem::~UBGraphicsMediaItem()
@@ -207,24 +325,19 @@ QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVaria
     }
     else if (change == QGraphicsItem::ItemSceneHasChanged)
     {
-        if (!scene())
+        if (!scene()) {
             stop();
-        else {
-            QString absoluteMediaFilename;
-
-            if(mMediaFileUrl.toLocalFile().startsWith("audios/") || mMediaFileUrl.toLocalFile().startsWith("videos/"))
-                absoluteMediaFilename = scene()->document()->persistencePath() + "/"  + mMediaFileUrl.toLocalFile();
-            else
-                absoluteMediaFilename = mMediaFileUrl.toLocalFile();
-
-            if (absoluteMediaFilename.length() > 0)
-            {
+            releaseMediaPlayer();
+        }
+        else if (mMediaObject) {
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                mMediaObject->setSource(QUrl::fromLocalFile(absoluteMediaFilename));
+            mMediaObject->setSource(absoluteMediaFileUrl());
 #else
-                mMediaObject->setMedia(QUrl::fromLocalFile(absoluteMediaFilename));
+            mMediaObject->setMedia(absoluteMediaFileUrl());
 #endif
-            }
+        }
+        else if (isOnActiveScene()) {
+            mediaPlayer();
         }
     }
 
@@ -248,11 +361,19 @@ void UBGraphicsMediaItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 QMediaPlayer::PlaybackState UBGraphicsMediaItem::playerState() const
 {
+    // without player, media left at a position is reported as paused so that the position is saved
+    if (!mMediaObject)
+        return (mInitialPos > 0) ? QMediaPlayer::PausedState : QMediaPlayer::StoppedState;
+
     return mMediaObject->playbackState();
 }
 #else
 QMediaPlayer::State UBGraphicsMediaItem::playerState() const
 {
+    // without player, media left at a position is reported as paused so that the position is saved
+    if (!mMediaObject)
+        return (mInitialPos > 0) ? QMediaPlayer::PausedState : QMediaPlayer::StoppedState;
+
     return mMediaObject->state();
 }
 #endif
@@ -277,17 +398,17 @@ void UBGraphicsMediaItem::setFirstLoad(bool firstLoad)
 
 qint64 UBGraphicsMediaItem::mediaDuration() const
 {
-    return mMediaObject->duration();
+    return mMediaObject ? mMediaObject->duration() : mDuration;
 }
 
 qint64 UBGraphicsMediaItem::mediaPosition() const
 {
-    return mMediaObject->position();
+    return mMediaObject ? mMediaObject->position() : mInitialPos;
 }
 
 bool UBGraphicsMediaItem::isMediaSeekable() const
 {
-    return mMediaObject->isSeekable();
+    return mMediaObject && mMediaObject->isSeekable();
 }
 
 /**
@@ -329,7 +450,10 @@ void UBGraphicsMediaItem::setInitialPos(qint64 p)
 
 void UBGraphicsMediaItem::setMediaPos(qint64 p)
 {
-    mMediaObject->setPosition(p);
+    if (mMediaObject)
+        mMediaObject->setPosition(p);
+    else
+        mInitialPos = p;
 }
 
 void UBGraphicsMediaItem::setSelected(bool selected)
@@ -369,11 +493,7 @@ void UBGraphicsMediaItem::toggleMute()
 void UBGraphicsMediaItem::setMute(bool bMute)
 {
     mMuted = bMute;
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    mMediaObject->audioOutput()->setMuted(mMuted);
-#else
-    mMediaObject->setMuted(mMuted);
-#endif
+    applyMute();
     mMutedByUserAction = mMuted;
     sIsMutedByDefault = mMuted;
 }
@@ -387,8 +507,14 @@ std::shared_ptr<UBGraphicsScene> UBGraphicsMediaItem::scene()
 
 void UBGraphicsMediaItem::activeSceneChanged()
 {
-    if (UBApplication::boardController->activeScene() != scene())
-        pause();
+    if (isOnActiveScene()) {
+        mediaPlayer();
+    }
+    else {
+        if (isPlaying())
+            pause();
+        releaseMediaPlayer();
+    }
 }
 
 
@@ -396,36 +522,32 @@ void UBGraphicsMediaItem::showOnDisplayChanged(bool shown)
 {
     if (!shown) {
         mMuted = true;
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->audioOutput()->setMuted(mMuted);
-#else
-        mMediaObject->setMuted(mMuted);
-#endif
+        applyMute();
     }
     else if (!mMutedByUserAction) {
         mMuted = false;
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->audioOutput()->setMuted(mMuted);
-#else
-        mMediaObject->setMuted(mMuted);
-#endif
+        applyMute();
     }
 }
 void UBGraphicsMediaItem::play()
 {
-    mMediaObject->play();
+    mediaPlayer()->play();
     mStopped = false;
 }
 
 void UBGraphicsMediaItem::pause()
 {
-    mMediaObject->pause();
+    if (mMediaObject)
+        mMediaObject->pause();
     mStopped = false;
 }
 
 void UBGraphicsMediaItem::stop()
 {
-    mMediaObject->stop();
+    if (mMediaObject)
+        mMediaObject->stop();
+    else
+        mInitialPos = 0;
     mStopped = true;
 }
 
@@ -436,6 +558,8 @@ void UBGraphicsMediaItem::togglePlayPause()
         return;
     }
 
+    mediaPlayer();
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QMediaPlayer::PlaybackState state = mMediaObject->playbackState();
 #else
@@ -511,6 +635,13 @@ void UBGraphicsMediaItem::mediaError(QMediaPlayer::Error errorCode)
     }
 }
 
+void UBGraphicsMediaItem::mediaStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    // resume where the media was left before the player was released or the page saved
+    if (status == QMediaPlayer::LoadedMedia && mInitialPos > 0 && mMediaObject->position() == 0)
+        mMediaObject->setPosition(mInitialPos);
+}
+
 void UBGraphicsMediaItem::copyItemParameters(UBItem *copy) const
 {
     UBGraphicsMediaItem *cp = dynamic_cast<UBGraphicsMediaItem*>(copy);
@@ -624,7 +755,8 @@ void UBGraphicsVideoItem::setSize(int width, int height)
     else
         sizeY = height;
 
-    mVideoItem->setSize(QSize(sizeX, sizeY));
+    if (mVideoItem)
+        mVideoItem->setSize(QSize(sizeX, sizeY));
 
 
     UBGraphicsMediaItem::setSize(sizeX, sizeY);
@@ -661,24 +793,12 @@ void UBGraphicsVideoItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
     styleOption.state &= ~QStyle::State_Selected;
 
     QGraphicsRectItem::paint(painter, &styleOption, widget);
-    UBGraphicsMediaItem::paint(painter, option, widget);
 
-}
+    if (mPlaceholderVisible)
+        paintPoster(painter);
 
-QVariant UBGraphicsVideoItem::itemChange(GraphicsItemChange change, const QVariant &value) {
-    if (change == QGraphicsItem::ItemVisibleChange
-            && value.toBool()
-            && !mHasVideoOutput
-            && UBApplication::app()->boardController
-            && UBApplication::app()->boardController->activeScene() == scene())
-    {
-        //qDebug() << "Item change, setting video output";
-
-        mMediaObject->setVideoOutput(mVideoItem);
-        mHasVideoOutput = true;
-    }
+    UBGraphicsMediaItem::paint(painter, option, widget);
 
-    return UBGraphicsMediaItem::itemChange(change, value);
 }
 
 void UBGraphicsVideoItem::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
@@ -724,28 +844,6 @@ void UBGraphicsVideoItem::mediaStateChanged(QMediaPlayer::State state)
 
 }
 
-void UBGraphicsVideoItem::activeSceneChanged()
-{
-    //qDebug() << "Active scene changed";
-
-    // Update the visibility of the placeholder, to prevent it being hidden when switching pages
-    setPlaceholderVisible(!mErrorString.isEmpty());
-
-    // Call setVideoOutput, if the video is visible and if it hasn't been called already
-    if (!mHasVideoOutput && UBApplication::boardController->activeScene() == scene()) {
-        //qDebug() << "setting video output";
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        mMediaObject->setSource(mMediaFileUrl);
-#else
-        mMediaObject->setMedia(mMediaFileUrl);
-#endif
-        mMediaObject->setVideoOutput(mVideoItem);
-        mHasVideoOutput = true;
-    }
-
-    UBGraphicsMediaItem::activeSceneChanged();
-}
-
 void UBGraphicsVideoItem::mediaError(QMediaPlayer::Error errorCode)
 {
     setPlaceholderVisible(errorCode != QMediaPlayer::NoError);
@@ -761,6 +859,8 @@ void UBGraphicsVideoItem::mediaError(QMediaPlayer::Error errorCode)
  */
 void UBGraphicsVideoItem::setPlaceholderVisible(bool visible)
 {
+    mPlaceholderVisible = visible;
+
     if (visible) {
         setBrush(QColor(Qt::black));
         setPen(QColor(Qt::white));
@@ -771,3 +871,87 @@ void UBGraphicsVideoItem::setPlaceholderVisible(bool visible)
     }
 
 }
+
+QString UBGraphicsVideoItem::posterPath()
+{
+    // only media stored in the document get a poster
+    QString mediaFile = absoluteMediaFileUrl().toLocalFile();
+
+    if (!scene() || !scene()->document() || !mediaFile.startsWith(scene()->document()->persistencePath()))
+        return QString();
+
+    QFileInfo mediaInfo(mediaFile);
+    return mediaInfo.absolutePath() + "/" + mediaInfo.completeBaseName() + ".png";
+}
+
+void UBGraphicsVideoItem::paintPoster(QPainter *painter)
+{
+    if (mPosterMissing)
+        return;
+
+    QString path = posterPath();
+
+    if (path.isEmpty())
+        return;
+
+    QString key = QString("UBVideoPoster-%1").arg(path);
+    QPixmap poster;
+
+    if (!QPixmapCache::find(key, &poster))
+    {
+        if (!poster.load(path))
+        {
+            mPosterMissing = true;
+            return;
+        }
+
+        QPixmapCache::insert(key, poster);
+    }
+
+    QRectF target(QPointF(), QSizeF(poster.size()).scaled(rect().size(), Qt::KeepAspectRatio));
+    target.moveCenter(rect().center());
+
+    painter->drawPixmap(target, poster, poster.rect());
+}
+
+void UBGraphicsVideoItem::clearSource()
+{
+    QString path = posterPath();
+
+    UBGraphicsMediaItem::clearSource();
+
+    if (!path.isEmpty() && QFileInfo::exists(path))
+        UBFileSystemUtils::deleteFile(path);
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+void UBGraphicsVideoItem::videoFrameChanged(const QVideoFrame& frame)
+{
+    QString path = posterPath();
+
+    if (!frame.isValid() || path.isEmpty())
+        return;
+
+    QImage image = frame.toImage();
+
+    if (image.isNull())
+        return;
+
+    disconnect(mVideoItem->videoSink(), &QVideoSink::videoFrameChanged,
+               this, &UBGraphicsVideoItem::videoFrameChanged);
+
+    if (image.width() > sPosterMaxWidth)
+        image = image.scaledToWidth(sPosterMaxWidth, Qt::SmoothTransformation);
+
+    QPixmapCache::insert(QString("UBVideoPoster-%1").arg(path), QPixmap::fromImage(image));
+    mPosterMissing = false;
+
+    QFuture<void> posterWrite = QtConcurrent::run([image, path]() {
+        if (!image.save(path, "PNG"))
+            qWarning() << "cannot save video poster" << path;
+    });
+
+    // the poster is part of the document, it must be written before the document is exported or deleted
+    UBPersistenceManager::persistenceManager()->trackAssetCopy(posterWrite);
+}
+#endif
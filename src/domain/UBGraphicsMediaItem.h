@@ -85,13 +85,11 @@ public:
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QMediaPlayer::PlaybackState playerState() const;
-    bool isPlaying() const { return (mMediaObject->playbackState() == QMediaPlayer::PlayingState); }
-    bool isPaused() const { return (mMediaObject->playbackState() == QMediaPlayer::PausedState); }
 #else
     QMediaPlayer::State playerState() const;
-    bool isPlaying() const { return (mMediaObject->state() == QMediaPlayer::PlayingState); }
-    bool isPaused() const { return (mMediaObject->state() == QMediaPlayer::PausedState); }
 #endif
+    bool isPlaying() const { return (playerState() == QMediaPlayer::PlayingState); }
+    bool isPaused() const { return (playerState() == QMediaPlayer::PausedState); }
 
     bool isStopped() const;
     bool firstLoad() const;
@@ -132,6 +130,7 @@ public slots:
 
 protected slots:
     void mediaError(QMediaPlayer::Error errorCode);
+    void mediaStatusChanged(QMediaPlayer::MediaStatus status);
 
 protected:
 
@@ -140,6 +139,18 @@ protected:
 
     virtual void clearSource();
 
+    /**
+     * The media player is only created when playback is requested or when the page
+     * becomes active, so that pages loaded for the cache, export or thumbnails don't
+     * open any decoder.
+     */
+    QMediaPlayer* mediaPlayer();
+    virtual void setupMediaPlayer();
+    virtual void releaseMediaPlayer();
+    bool isOnActiveScene();
+    QUrl absoluteMediaFileUrl();
+    void applyMute();
+
     QMediaPlayer *mMediaObject;
 
     QSize mMinimumSize;
@@ -161,6 +172,7 @@ protected:
     QGraphicsPixmapItem *mLinkedImage;
 
     qint64 mInitialPos;
+    qint64 mDuration;
 
     QString mErrorString;
 };
@@ -180,6 +192,9 @@ public:
     mediaType getMediaType() const { return mediaType_Audio; }
 
     virtual UBItem* deepCopy() const;
+
+protected:
+    virtual void setupMediaPlayer();
 };
 
 class UBGraphicsVideoItem: public UBGraphicsMediaItem
@@ -213,23 +228,37 @@ public slots:
     void mediaStateChanged(QMediaPlayer::State state);
 #endif
 
-    void activeSceneChanged();
-
 protected slots:
     void mediaError(QMediaPlayer::Error errorCode);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    void videoFrameChanged(const QVideoFrame& frame);
+#endif
 
 protected:
 
     QGraphicsVideoItem *mVideoItem;
 
-    virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
     virtual void hoverEnterEvent(QGraphicsSceneHoverEvent *event);
     virtual void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
     virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
 
+    virtual void clearSource();
+    virtual void setupMediaPlayer();
+    virtual void releaseMediaPlayer();
+
     void setPlaceholderVisible(bool visible);
 
-    bool mHasVideoOutput;
+    /**
+     * The poster is a frame of the video saved next to it in the document, painted
+     * in place of the video as long as no frame is displayed by the player.
+     */
+    QString posterPath();
+    void paintPoster(QPainter *painter);
+
+    static const int sPosterMaxWidth = 640;
+
+    bool mPlaceholderVisible;
+    bool mPosterMissing;
 };
 
 
@@ -66,6 +66,11 @@ void UBGraphicsPDFItem::updateChild()
 
     // Workaround: Necessary, otherwise only the control scene is updated, the display scene refresh is ignored for an unknown reason.
     setCacheMode(prevCacheMode);
+
+    // a page background is part of the cached background of the views
+    std::shared_ptr<UBGraphicsScene> ubScene = scene();
+    if (ubScene && ubScene->isBackgroundObject(this))
+        ubScene->invalidateBackgroundObject();
 }
 
 void UBGraphicsPDFItem::setUuid(const QUuid &pUuid)
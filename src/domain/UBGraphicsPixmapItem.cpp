@@ -41,11 +41,14 @@
 
 #include "core/UBApplication.h"
 #include "core/UBPersistenceManager.h"
+#include "core/UBMimeData.h"
 
 #include "board/UBBoardController.h"
 
 #include "core/memcheck.h"
 
+static const int sDragPixmapWidth = 100;
+
 UBGraphicsPixmapItem::UBGraphicsPixmapItem(QGraphicsItem* parent)
     : QGraphicsPixmapItem(parent)
 {
@@ -84,15 +87,6 @@ void UBGraphicsPixmapItem::setUuid(const QUuid &pUuid)
 
 void UBGraphicsPixmapItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    QMimeData* pMime = new QMimeData();
-    pMime->setImageData(pixmap().toImage());
-    Delegate()->setMimeData(pMime);
-    qreal k = (qreal)pixmap().width() / 100.0;
-
-    QSize newSize((int)(pixmap().width() / k), (int)(pixmap().height() / k));
-
-    Delegate()->setDragPixmap(pixmap().scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-
     if (Delegate()->mousePressEvent(event))
     {
         //NOOP
@@ -103,6 +97,33 @@ void UBGraphicsPixmapItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
     }
 }
 
+QMimeData* UBGraphicsPixmapItem::dragMimeData() const
+{
+    QPixmap source = pixmap();
+
+    return new UBMimeDataImage([source]() {
+        return source.toImage();
+    });
+}
+
+QPixmap UBGraphicsPixmapItem::dragPixmap() const
+{
+    if (pixmap().isNull())
+        return QPixmap();
+
+    // downscaled renditions are shared by all items showing the same pixmap
+    QString key = QString("UBDragPixmap-%1").arg(pixmap().cacheKey());
+    QPixmap preview;
+
+    if (!QPixmapCache::find(key, &preview))
+    {
+        preview = pixmap().scaledToWidth(sDragPixmapWidth, Qt::SmoothTransformation);
+        QPixmapCache::insert(key, preview);
+    }
+
+    return preview;
+}
+
 void UBGraphicsPixmapItem::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
     if (Delegate()->mouseMoveEvent(event))
@@ -67,6 +67,10 @@ class UBGraphicsPixmapItem : public QObject, public QGraphicsPixmapItem, public
 
         virtual void setUuid(const QUuid &pUuid);
 
+        virtual bool isDragSource() const { return true; }
+        virtual QMimeData* dragMimeData() const;
+        virtual QPixmap dragPixmap() const;
+
 protected:
 
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -114,6 +114,15 @@ UBGraphicsPolygonItem::~UBGraphicsPolygonItem()
     clearStroke();
 }
 
+QVariant UBGraphicsPolygonItem::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    // polygons usually join the scene through their strokes group
+    if (change == QGraphicsItem::ItemSceneHasChanged)
+        UBGraphicsScene::itemSceneHasChanged(this);
+
+    return QGraphicsPolygonItem::itemChange(change, value);
+}
+
 void UBGraphicsPolygonItem::setStrokesGroup(UBGraphicsStrokesGroup *group)
 {
     mpGroup = group;
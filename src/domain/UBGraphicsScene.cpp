@@ -41,6 +41,7 @@
 #include "core/UBApplicationController.h"
 #include "core/UBPersistenceManager.h"
 #include "core/UBTextTools.h"
+#include "core/UBTrace.h"
 
 #include "gui/UBMagnifer.h"
 #include "gui/UBMainWindow.h"
@@ -77,6 +78,7 @@
 #include "domain/UBGraphicsGroupContainerItem.h"
 
 #include "UBGraphicsStroke.h"
+#include "UBBackgroundRenderer.h"
 
 #include "core/memcheck.h"
 
@@ -118,6 +120,11 @@ qreal UBZLayerController::generateZLevel(itemLayerType::Enum key)
     qreal incrementalStep = scopeMap.value(key).incStep;
 
     result += incrementalStep;
+    if (result >= top && scopeMap.value(key).topLimit != scopeMap.value(key).bottomLimit) {
+        // the values drifted up to the top of the scope, pack the items of the layer
+        renumberLayer(key);
+        result = scopeMap.value(key).curValue + incrementalStep;
+    }
     if (result >= top) {
         // If not only one variable presents in the scope, notify that values for scope are over
         if (scopeMap.value(key).topLimit != scopeMap.value(key).bottomLimit) {
@@ -150,31 +157,26 @@ qreal UBZLayerController::changeZLevelTo(QGraphicsItem *item, moveDestination de
         return errorNum();
     }
 
-    //select only items wiht the same z-level as item's one and push it to sortedItems QMultiMap
-    QMultiMap<qreal, QGraphicsItem*> sortedItems;
-    if (mScene->items().count()) {
-        foreach (QGraphicsItem *tmpItem, mScene->items()) {
-            if (typeForData(tmpItem) == curItemLayerType) {
-                sortedItems.insert(tmpItem->data(UBGraphicsItemData::ItemOwnZValue).toReal(), tmpItem);
-            }
-        }
-    }
+    //items with the same z-level as item's one, sorted by their own z value
+    const LayerItems &sortedItems = mLayerItems[curItemLayerType];
+    qreal curZValue = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
 
     //If only one item itself - do nothing, return it's z-value
-    if (sortedItems.count() == 1 && sortedItems.first() == item) {
+    if (sortedItems.isEmpty() || (sortedItems.count() == 1 && sortedItems.first() == item)) {
         qDebug() << "only one item exists in layer. Have nothing to change";
-        return item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
+        return curZValue;
     }
 
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    QMultiMapIterator<qreal, QGraphicsItem*>iCurElement(sortedItems);
-#else
-    QMapIterator<qreal, QGraphicsItem*>iCurElement(sortedItems);
-#endif
+    ItemLayerTypeData curItemLayerTypeData = scopeMap.value(curItemLayerType);
 
     if (dest == up)
     {
-        qreal newZValue = item->data(UBGraphicsItemData::ItemOwnZValue).toReal() + 1;
+        qreal newZValue = curZValue + 1;
+        if (newZValue >= curItemLayerTypeData.topLimit) {
+            renumberLayer(curItemLayerType);
+            newZValue = item->data(UBGraphicsItemData::ItemOwnZValue).toReal() + 1;
+        }
+
         UBGraphicsItem::assignZValue(item, newZValue);
         shiftStoredZValue(item, newZValue);
 
@@ -183,16 +185,19 @@ qreal UBZLayerController::changeZLevelTo(QGraphicsItem *item, moveDestination de
     }
     else if (dest == top)
     {
-        if (iCurElement.findNext(item)) {
-            if (iCurElement.hasNext()) {
-                UBGraphicsItem::assignZValue(item, generateZLevel(item));
-            }
+        if (sortedItems.last() != item) {
+            UBGraphicsItem::assignZValue(item, generateZLevel(item));
         }
     }
     else if (dest == down)
     {
-        qreal newZValue = item->data(UBGraphicsItemData::ItemOwnZValue).toReal()-1;
-        if (newZValue >= -999999.0)
+        qreal newZValue = curZValue - 1;
+        if (newZValue <= curItemLayerTypeData.bottomLimit && sortedItems.first() != item) {
+            renumberLayer(curItemLayerType);
+            newZValue = item->data(UBGraphicsItemData::ItemOwnZValue).toReal() - 1;
+        }
+
+        if (newZValue > curItemLayerTypeData.bottomLimit)
         {
             UBGraphicsItem::assignZValue(item, newZValue);
             shiftStoredZValue(item, newZValue);
@@ -207,60 +212,23 @@ qreal UBZLayerController::changeZLevelTo(QGraphicsItem *item, moveDestination de
     }
     else if (dest == bottom)
     {
-        iCurElement.toBack();
-        if (iCurElement.findPrevious(item)) {
-            if (iCurElement.hasPrevious()) {
-                qreal oldz = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                iCurElement.toFront();
-                qreal nextZ = iCurElement.next().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-
-                ItemLayerTypeData curItemLayerTypeData = scopeMap.value(curItemLayerType);
-
-                //if we have some free space between lowest graphics item and layer's bottom bound,
-                //insert element close to first element in layer
-                if (nextZ > curItemLayerTypeData.bottomLimit + curItemLayerTypeData.incStep) {
-                    qreal result = nextZ - curItemLayerTypeData.incStep;
-                    UBGraphicsItem::assignZValue(item, result);
-                } else {
-                    UBGraphicsItem::assignZValue(item, nextZ);
-
-                    bool doubleGap = false; //to detect if we can finish rundown since we can insert item to the free space
-
-                    while (iCurElement.peekNext().value() != item) {
-                        qreal curZ = iCurElement.value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                        qreal curNextZ = iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                        if (curNextZ - curZ >= 2 * curItemLayerTypeData.incStep) {
-                            UBGraphicsItem::assignZValue(iCurElement.value(), curZ + curItemLayerTypeData.incStep);
-                            doubleGap = true;
-                            break;
-                        } else {
-                            UBGraphicsItem::assignZValue(iCurElement.value(), curNextZ);
-                            iCurElement.next();
-                        }
-                    }
-                    if (!doubleGap) {
+        if (sortedItems.first() != item) {
+            qreal nextZ = sortedItems.firstKey();
 
-                        UBGraphicsItem::assignZValue(iCurElement.value(), oldz);
-
-                        while (iCurElement.hasNext() && (iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal() == oldz)) {
-                            UBGraphicsItem::assignZValue(iCurElement.next().value(), oldz);
-                        }
-                    }
-                }
+            //if we have some free space between lowest graphics item and layer's bottom bound,
+            //insert element close to first element in layer, otherwise pack the layer above it
+            if (nextZ > curItemLayerTypeData.bottomLimit + curItemLayerTypeData.incStep) {
+                UBGraphicsItem::assignZValue(item, nextZ - curItemLayerTypeData.incStep);
+            } else {
+                renumberLayer(curItemLayerType, item);
             }
         }
     }
 
-
     //clear selection of the item and then select it again to activate selectionChangeProcessing()
     item->scene()->clearSelection();
     item->setSelected(true);
 
-    foreach (QGraphicsItem *iitem, sortedItems.values()) {
-        if (iitem)
-            iitem != item ? qDebug() <<  "current value" << iitem->zValue() : qDebug() << "marked value" << QString::number(iitem->zValue(), 'f');
-    }
-
     //Return new z value assigned to item
     
     // experimental
@@ -283,6 +251,7 @@ itemLayerType::Enum UBZLayerController::typeForData(QGraphicsItem *item) const
 void UBZLayerController::setLayerType(QGraphicsItem *pItem, itemLayerType::Enum pNewType)
 {
    pItem->setData(UBGraphicsItemData::itemLayerType, QVariant(pNewType));
+   updateItem(pItem);
 }
 
 void UBZLayerController::shiftStoredZValue(QGraphicsItem *item, qreal zValue)
@@ -314,6 +283,92 @@ bool UBZLayerController::zLevelAvailable(QGraphicsItem* item)
     return true;
 }
 
+void UBZLayerController::addItem(QGraphicsItem *item)
+{
+    if (mItemPositions.contains(item))
+        removeItem(item);
+
+    LayerPosition position(typeForData(item), item->data(UBGraphicsItemData::ItemOwnZValue).toReal());
+
+    mLayerItems[position.first].insert(position.second, item);
+    mItemPositions.insert(item, position);
+}
+
+/**
+ * @brief Removes the item from the index. Only the stored position is used, so that it can be called
+ * while the item is being destroyed.
+ */
+void UBZLayerController::removeItem(QGraphicsItem *item)
+{
+    QHash<QGraphicsItem*, LayerPosition>::iterator position = mItemPositions.find(item);
+
+    if (position != mItemPositions.end()) {
+        mLayerItems[position->first].remove(position->second, item);
+        mItemPositions.erase(position);
+    }
+}
+
+/**
+ * @brief Moves an indexed item to its current layer and own z value.
+ */
+void UBZLayerController::updateItem(QGraphicsItem *item)
+{
+    QHash<QGraphicsItem*, LayerPosition>::const_iterator position = mItemPositions.constFind(item);
+
+    if (position == mItemPositions.constEnd())
+        return;
+
+    if (position->first != typeForData(item)
+            || position->second != item->data(UBGraphicsItemData::ItemOwnZValue).toReal()) {
+        addItem(item);
+    }
+}
+
+void UBZLayerController::clearItems()
+{
+    mLayerItems.clear();
+    mItemPositions.clear();
+}
+
+/**
+ * @brief Reassigns evenly spaced z values from the bottom of the layer, keeping the items order.
+ * Used when the values drifted to the bounds of the layer.
+ * @param lowestItem if set, this item is moved below all the other items of the layer
+ */
+void UBZLayerController::renumberLayer(itemLayerType::Enum key, QGraphicsItem *lowestItem)
+{
+    if (!validLayerType(key) || key == itemLayerType::NoLayer)
+        return;
+
+    ItemLayerTypeData &typeData = scopeMap[key];
+
+    if (typeData.topLimit == typeData.bottomLimit)
+        return;
+
+    QList<QGraphicsItem*> orderedItems = mLayerItems.value(key).values();
+
+    if (lowestItem && orderedItems.removeOne(lowestItem))
+        orderedItems.prepend(lowestItem);
+
+    // leave room for new items above the renumbered ones
+    qreal step = qMin(typeData.incStep, (typeData.topLimit - typeData.bottomLimit) / (2 * orderedItems.count() + 1));
+    qreal zValue = typeData.bottomLimit;
+
+    LayerItems renumberedItems;
+    foreach (QGraphicsItem *item, orderedItems) {
+        zValue += step;
+        renumberedItems.insert(zValue, item);
+        mItemPositions[item].second = zValue;
+    }
+
+    mLayerItems.insert(key, renumberedItems);
+    typeData.curValue = zValue;
+
+    // the index is already up to date, reindexing from UBGraphicsItem::assignZValue does nothing
+    for (LayerItems::const_iterator it = renumberedItems.constBegin(); it != renumberedItems.constEnd(); ++it)
+        UBGraphicsItem::assignZValue(it.value(), it.key());
+}
+
 UBGraphicsScene::UBGraphicsScene(std::shared_ptr<UBDocumentProxy> document, bool enableUndoRedoStack)
     : mEraser(0)
     , mPointer(0)
@@ -332,6 +387,7 @@ UBGraphicsScene::UBGraphicsScene(std::shared_ptr<UBDocumentProxy> document, bool
     , mRenderingContext(Screen)
     , mCurrentStroke(0)
     , mItemCount(0)
+    , mBulkChangeDepth(0)
     , mUndoRedoStackEnabled(enableUndoRedoStack)
     , magniferControlViewWidget(0)
     , magniferDisplayViewWidget(0)
@@ -365,7 +421,7 @@ UBGraphicsScene::UBGraphicsScene(std::shared_ptr<UBDocumentProxy> document, bool
 
 //    Just for debug. Do not delete please
 //    connect(this, SIGNAL(selectionChanged()), this, SLOT(selectionChangedProcessing()));
-    connect(UBApplication::undoStack.data(), SIGNAL(indexChanged(int)), this, SLOT(updateSelectionFrameWrapper(int)));
+    connect(UBApplication::undoGroup.data(), SIGNAL(indexChanged(int)), this, SLOT(updateSelectionFrameWrapper(int)));
     connect(UBDrawingController::drawingController(), SIGNAL(stylusToolChanged(int,int)), this, SLOT(stylusToolChanged(int,int)));
     connect(UBApplication::boardController, &UBBoardController::zoomChanged, this, &UBGraphicsScene::zoomChanged);
 }
@@ -375,6 +431,9 @@ UBGraphicsScene::~UBGraphicsScene()
     // disconnect all consumers of this signal at once to speed-up deletion of scene
     disconnect(this, &UBGraphicsScene::zoomChanged, nullptr, nullptr);
 
+    // the items are deleted after the indexes, they must not reference them anymore
+    clearItemIndexes();
+
     if (mCurrentStroke && mCurrentStroke->polygons().empty()){
         delete mCurrentStroke;
         mCurrentStroke = NULL;
@@ -410,6 +469,8 @@ QPointF UBGraphicsScene::lastCenter()
 
 bool UBGraphicsScene::inputDevicePress(const QPointF& scenePos, const qreal& pressure, Qt::KeyboardModifiers modifiers)
 {
+    UB_TRACE_SCOPE("scene", "inputDevicePress");
+
     bool accepted = false;
 
     if (mInputDeviceIsPressed) {
@@ -509,6 +570,8 @@ bool UBGraphicsScene::inputDevicePress(const QPointF& scenePos, const qreal& pre
 
 bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pressure, Qt::KeyboardModifiers modifiers)
 {
+    UB_TRACE_SCOPE("scene", "inputDeviceMove");
+
     bool accepted = false;
 
     UBDrawingController *dc = UBDrawingController::drawingController();
@@ -582,7 +645,7 @@ bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pres
 
                 if (isSnapping())
                 {
-                    double step = UBSettings::settings()->rotationAngleStep->get().toDouble();
+                    double step = UBSettings::settings()->rotationAngleStep->getReal();
                     QLineF radius(mPreviousPoint, position);
                     qreal angle = radius.angle();
                     angle = qRound(angle / step) * step;
@@ -632,8 +695,8 @@ bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pres
             else {
                 bool interpolate = false;
 
-                if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardInterpolatePenStrokes->get().toBool())
-                    || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardInterpolateMarkerStrokes->get().toBool()))
+                if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardInterpolatePenStrokes->getBool())
+                    || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardInterpolateMarkerStrokes->getBool()))
                 {
                     interpolate = true;
                 }
@@ -698,6 +761,8 @@ bool UBGraphicsScene::inputDeviceMove(const QPointF& scenePos, const qreal& pres
 
 bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifiers)
 {
+    UB_TRACE_SCOPE("scene", "inputDeviceRelease");
+
     bool accepted = false;
 
     if (mPointer)
@@ -753,8 +818,8 @@ bool UBGraphicsScene::inputDeviceRelease(int tool, Qt::KeyboardModifiers modifie
             }
 
             // replace the stroke by a simplified version of it
-            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardSimplifyPenStrokes->get().toBool())
-                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardSimplifyMarkerStrokes->get().toBool()))
+            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardSimplifyPenStrokes->getBool())
+                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardSimplifyMarkerStrokes->getBool()))
             {
                 simplifyCurrentStroke();
             }
@@ -885,8 +950,8 @@ void UBGraphicsScene::drawPenCircle(const QPointF &pPoint)
 {
     QCursor cursor;
 
-    if (mPenCircle && UBSettings::settings()->showPenPreviewCircle->get().toBool() &&
-        UBSettings::settings()->currentPenWidth() >= UBSettings::settings()->penPreviewFromSize->get().toInt()) {
+    if (mPenCircle && UBSettings::settings()->showPenPreviewCircle->getBool() &&
+        UBSettings::settings()->currentPenWidth() >= UBSettings::settings()->penPreviewFromSize->getInt()) {
         qreal penDiameter = UBSettings::settings()->currentPenWidth();
         penDiameter /= UBApplication::boardController->systemScaleFactor();
         penDiameter /= UBApplication::boardController->currentZoom();
@@ -1563,6 +1628,8 @@ void UBGraphicsScene::clearContent(clearCase pCase)
         mBackgroundObject = 0;
     }
 
+    invalidateBackgroundObject();
+
     setDocumentUpdated();
 }
 
@@ -1951,6 +2018,7 @@ UBGraphicsTextItem* UBGraphicsScene::addTextWithFont(const QString& pString, con
 
     connect(textItem, SIGNAL(textUndoCommandAdded(UBGraphicsTextItem*)), this, SLOT(textUndoCommandAdded(UBGraphicsTextItem*)));
 
+    textItem->setTextInteractionFlags(Qt::TextEditorInteraction);
     textItem->setSelected(true);
     textItem->setFocus();
 
@@ -1989,6 +2057,7 @@ UBGraphicsTextItem *UBGraphicsScene::addTextHtml(const QString &pString, const Q
 void UBGraphicsScene::addItem(QGraphicsItem* item)
 {
     UBCoreGraphicsScene::addItem(item);
+    indexItemTree(item, true);
 
     // the default z value is already set. This is the case when a svg file is read
     if(item->zValue() == DEFAULT_Z_VALUE
@@ -2026,6 +2095,7 @@ void UBGraphicsScene::addItems(const QSet<QGraphicsItem*>& items)
 {
     foreach(QGraphicsItem* item, items) {
         UBCoreGraphicsScene::addItem(item);
+        indexItemTree(item, true);
         UBGraphicsItem::assignZValue(item, mZLayerController->generateZLevel(item));
     }
 
@@ -2037,8 +2107,12 @@ void UBGraphicsScene::removeItem(QGraphicsItem* item)
 {
     item->setSelected(false);
     UBCoreGraphicsScene::removeItem(item);
+    indexItemTree(item, false);
     UBApplication::boardController->freezeW3CWidget(item, true);
 
+    if (isBackgroundObject(item))
+        invalidateBackgroundObject();
+
     if (!mTools.contains(item))
     {
         --mItemCount;
@@ -2048,13 +2122,29 @@ void UBGraphicsScene::removeItem(QGraphicsItem* item)
 
 void UBGraphicsScene::removeItems(const QSet<QGraphicsItem*>& items)
 {
-    foreach(QGraphicsItem* item, items)
+    foreach(QGraphicsItem* item, items) {
         UBCoreGraphicsScene::removeItem(item);
+        indexItemTree(item, false);
+    }
 
     mItemCount -= items.size();
     setModified(true);
 }
 
+void UBGraphicsScene::beginBulkChange()
+{
+    // removing an item from the BSP tree is proportional to the items sharing its leaves,
+    // the linear index keeps bulk changes linear and the tree is rebuilt once afterwards
+    if (mBulkChangeDepth++ == 0)
+        setItemIndexMethod(NoIndex);
+}
+
+void UBGraphicsScene::endBulkChange()
+{
+    if (mBulkChangeDepth > 0 && --mBulkChangeDepth == 0)
+        setItemIndexMethod(BspTreeIndex);
+}
+
 void UBGraphicsScene::deselectAllItems()
 {
     foreach(QGraphicsItem *gi, selectedItems())
@@ -2134,6 +2224,8 @@ QGraphicsItem* UBGraphicsScene::setAsBackgroundObject(QGraphicsItem* item, bool
 
     }
 
+    invalidateBackgroundObject();
+
     return item;
 }
 
@@ -2150,6 +2242,23 @@ void UBGraphicsScene::unsetBackgroundObject()
     // it may depend on the object type, where it was before, etc.
 
     mBackgroundObject = 0;
+
+    invalidateBackgroundObject();
+}
+
+void UBGraphicsScene::invalidateBackgroundObject()
+{
+    QRectF backgroundObjectRect;
+
+    if (mBackgroundObject && mBackgroundObject->scene() == this)
+        backgroundObjectRect = mBackgroundObject->sceneBoundingRect();
+
+    // also repaint where the object was before
+    QRectF invalidatedRect = mBackgroundObjectRect.united(backgroundObjectRect);
+    mBackgroundObjectRect = backgroundObjectRect;
+
+    if (!invalidatedRect.isEmpty())
+        invalidate(invalidatedRect, QGraphicsScene::BackgroundLayer);
 }
 
 QRectF UBGraphicsScene::normalizedSceneRect(qreal ratio)
@@ -2193,17 +2302,118 @@ QRectF UBGraphicsScene::normalizedSceneRect(qreal ratio)
 
 QGraphicsItem *UBGraphicsScene::itemForUuid(QUuid uuid)
 {
-    QGraphicsItem *result = 0;
+    if (uuid.isNull())
+        return 0;
 
-    //simple search before implementing container for fast access
-    foreach (QGraphicsItem *item, items())
+    return indexedItem(uuid);
+}
+
+void UBGraphicsScene::itemSceneHasChanged(QGraphicsItem *item)
+{
+    UBItem *ubItem = dynamic_cast<UBItem*>(item);
+
+    if (!ubItem)
+        return;
+
+    UBGraphicsScene *scene = dynamic_cast<UBGraphicsScene*>(item->scene());
+    UBGraphicsScene *previousScene = ubItem->mIndexScene;
+
+    if (previousScene == scene)
+        return;
+
+    if (previousScene)
+        previousScene->unindexItem(ubItem);
+
+    if (scene)
+        scene->indexItem(ubItem, item);
+
+    if (item->type() == UBGraphicsPolygonItem::Type)
     {
-        if (UBGraphicsScene::getPersonalUuid(item) == uuid && !uuid.isNull()) {
-            result = item;
-        }
+        if (previousScene)
+            emit previousScene->polygonItemRemoved(item);
+
+        if (scene)
+            emit scene->polygonItemAdded(item);
     }
+}
 
-    return result;
+QGraphicsItem *UBGraphicsScene::indexedItem(const QUuid& uuid) const
+{
+    UBItem *ubItem = mItemsByUuid.value(uuid);
+    QGraphicsItem *item = dynamic_cast<QGraphicsItem*>(ubItem);
+
+    // the item may have left the scene without going through removeItem
+    return (item && item->scene() == this) ? item : 0;
+}
+
+void UBGraphicsScene::indexItem(UBItem* ubItem, QGraphicsItem* item)
+{
+    if (ubItem->mIndexScene == this)
+        return;
+
+    if (ubItem->mIndexScene)
+        ubItem->mIndexScene->unindexItem(ubItem);
+
+    mIndexedItems.insert(ubItem, item);
+    mItemsByUuid.insert(ubItem->mUuid, ubItem);
+    mZLayerController->addItem(item);
+    ubItem->mIndexScene = this;
+}
+
+void UBGraphicsScene::unindexItem(UBItem* ubItem)
+{
+    // may be called from ~UBItem, the graphics item must only be used as a key here
+    QGraphicsItem *item = mIndexedItems.take(ubItem);
+
+    if (mItemsByUuid.value(ubItem->mUuid) == ubItem)
+        mItemsByUuid.remove(ubItem->mUuid);
+
+    if (item)
+        mZLayerController->removeItem(item);
+
+    ubItem->mIndexScene = nullptr;
+}
+
+void UBGraphicsScene::reindexUuid(UBItem* ubItem, const QUuid& previousUuid)
+{
+    if (mItemsByUuid.value(previousUuid) == ubItem)
+        mItemsByUuid.remove(previousUuid);
+
+    mItemsByUuid.insert(ubItem->mUuid, ubItem);
+}
+
+void UBGraphicsScene::reindexZLevel(QGraphicsItem* item)
+{
+    UBItem *ubItem = dynamic_cast<UBItem*>(item);
+
+    if (ubItem && ubItem->mIndexScene == this)
+        mZLayerController->updateItem(item);
+}
+
+void UBGraphicsScene::indexItemTree(QGraphicsItem* item, bool index)
+{
+    UBItem *ubItem = dynamic_cast<UBItem*>(item);
+
+    if (ubItem)
+    {
+        if (index)
+            indexItem(ubItem, item);
+        else if (ubItem->mIndexScene == this)
+            unindexItem(ubItem);
+    }
+
+    foreach (QGraphicsItem *child, item->childItems())
+        indexItemTree(child, index);
+}
+
+void UBGraphicsScene::clearItemIndexes()
+{
+    foreach (UBItem *ubItem, mIndexedItems.keys())
+        ubItem->mIndexScene = nullptr;
+
+    mIndexedItems.clear();
+    mItemsByUuid.clear();
+    mZLayerController->clearItems();
 }
 
 void UBGraphicsScene::setDocument(std::shared_ptr<UBDocumentProxy> pDocument)
@@ -2340,8 +2550,11 @@ void UBGraphicsScene::addMagnifier(UBMagnifierParams params)
     magniferDisplayViewWidget->setSize(params.sizePercentFromScene);
     magniferDisplayViewWidget->setZoom(params.zoom);
 
+    // the scene is rendered once by the control view magnifier and shared with the display one
+    magniferControlViewWidget->setMirror(magniferDisplayViewWidget);
+
     magniferControlViewWidget->grabNMove(globalPoint, globalPoint, true);
-    magniferDisplayViewWidget->grabNMove(globalPoint, dvPoint, true);
+    magniferDisplayViewWidget->grabNMove(globalPoint, dvPoint, false);
     magniferControlViewWidget->show();
     magniferDisplayViewWidget->show();
 
@@ -2351,8 +2564,6 @@ void UBGraphicsScene::addMagnifier(UBMagnifierParams params)
     connect(magniferControlViewWidget, SIGNAL(magnifierZoomOut_Signal()), this, SLOT(zoomOutMagnifier()));
     connect(magniferControlViewWidget, SIGNAL(magnifierDrawingModeChange_Signal(int)), this, SLOT(changeMagnifierMode(int)));
     connect(magniferControlViewWidget, SIGNAL(magnifierResized_Signal(qreal)), this, SLOT(resizedMagnifier(qreal)));
-
-    setModified(true);
 }
 
 void UBGraphicsScene::moveMagnifier()
@@ -2361,7 +2572,6 @@ void UBGraphicsScene::moveMagnifier()
    {
        QPoint magnifierPos = QPoint(magniferControlViewWidget->pos().x() + magniferControlViewWidget->size().width() / 2, magniferControlViewWidget->pos().y() + magniferControlViewWidget->size().height() / 2 );
        moveMagnifier(magnifierPos, true);
-       setModified(true);
    }
 }
 
@@ -2385,16 +2595,14 @@ void UBGraphicsScene::moveMagnifier(QPoint newPos, bool forceGrab)
     QPoint cvPoint = cView->mapFromGlobal(globalPoint);
     QPoint dvPoint( cvPoint.x() * wCoeff + dvZeroPoint.x(), cvPoint.y() * hCoeff + dvZeroPoint.y());
 
+    // the magnifier is not part of the page, moving it must not trigger an autosave
     magniferControlViewWidget->grabNMove(globalPoint, globalPoint, forceGrab, false);
-    magniferDisplayViewWidget->grabNMove(globalPoint, dvPoint, forceGrab, true);
-
-    setModified(true);
+    magniferDisplayViewWidget->grabNMove(globalPoint, dvPoint, false, true);
 }
 
 void UBGraphicsScene::closeMagnifier()
 {
     DisposeMagnifierQWidgets();
-    setModified(true);
 }
 
 void UBGraphicsScene::zoomInMagnifier()
@@ -2412,7 +2620,6 @@ void UBGraphicsScene::zoomOutMagnifier()
     {
         magniferControlViewWidget->setZoom(magniferControlViewWidget->params.zoom - 0.5);
         magniferDisplayViewWidget->setZoom(magniferDisplayViewWidget->params.zoom - 0.5);
-        setModified(true);
     }
 }
 
@@ -2433,7 +2640,6 @@ void UBGraphicsScene::resizedMagnifier(qreal newPercent)
         magniferControlViewWidget->grabPoint();
         magniferDisplayViewWidget->setSize(newPercent);
         magniferDisplayViewWidget->grabPoint();
-        setModified(true);
     }
 }
 
@@ -2836,13 +3042,13 @@ void UBGraphicsScene::setOwnZlevel(QGraphicsItem *item)
 
 QUuid UBGraphicsScene::getPersonalUuid(QGraphicsItem *item)
 {
-    QString idCandidate = item->data(UBGraphicsItemData::ItemUuid).toString();
-    return idCandidate == QUuid().toString() ? QUuid() : QUuid(idCandidate);
+    return item->data(UBGraphicsItemData::ItemUuid).toUuid();
 }
 
 qreal UBGraphicsScene::changeZLevelTo(QGraphicsItem *item, UBZLayerController::moveDestination dest, bool addUndo)
 {
     qreal previousZVal = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
+
     qreal res = mZLayerController->changeZLevelTo(item, dest);
 
     if(addUndo){
@@ -2877,7 +3083,7 @@ void UBGraphicsScene::drawItems (QPainter * painter, int numItems,
 
         for (int i = 0; i < numItems; i++)
         {
-            if (!mTools.contains(rootItem(items[i])))
+            if (!mTools.contains(rootItem(items[i])) && !isBackgroundObject(items[i]))
             {
                 bool isPdfItem =  qgraphicsitem_cast<UBGraphicsPDFItem*> (items[i]) != NULL;
                 if(!isPdfItem || mRenderingContext == NonScreen)
@@ -2906,7 +3112,7 @@ void UBGraphicsScene::drawItems (QPainter * painter, int numItems,
         {
             bool ok;
             int itemLayerType = items[i]->data(UBGraphicsItemData::ItemLayerType).toInt(&ok);
-            if (ok && (itemLayerType >= UBItemLayerType::FixedBackground && itemLayerType <= UBItemLayerType::Tool))
+            if (ok && (itemLayerType >= UBItemLayerType::FixedBackground && itemLayerType <= UBItemLayerType::Tool) && !isBackgroundObject(items[i]))
             {
                 itemsFiltered[count] = items[i];
                 optionsFiltered[count] = options[i];
@@ -2920,6 +3126,29 @@ void UBGraphicsScene::drawItems (QPainter * painter, int numItems,
         delete[] itemsFiltered;
 
     }
+    else if (mBackgroundObject && !mIsDesktopMode)
+    {
+        // the background object was already drawn with the background
+        int count = 0;
+
+        QGraphicsItem** itemsFiltered = new QGraphicsItem*[numItems];
+        QStyleOptionGraphicsItem *optionsFiltered = new QStyleOptionGraphicsItem[numItems];
+
+        for (int i = 0; i < numItems; i++)
+        {
+            if (!isBackgroundObject(items[i]))
+            {
+                itemsFiltered[count] = items[i];
+                optionsFiltered[count] = options[i];
+                count++;
+            }
+        }
+
+        QGraphicsScene::drawItems(painter, count, itemsFiltered, optionsFiltered, widget);
+
+        delete[] optionsFiltered;
+        delete[] itemsFiltered;
+    }
     else
     {
         QGraphicsScene::drawItems(painter, numItems, items, options, widget);
@@ -2950,9 +3179,9 @@ void UBGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
         QColor bgCrossColor;
 
         if (darkBackground)
-            bgCrossColor = QColor(UBSettings::settings()->boardCrossColorDarkBackground->get().toString());
+            bgCrossColor = UBSettings::settings()->boardCrossColorDarkBackground->getColor();
         else
-            bgCrossColor = QColor(UBSettings::settings()->boardCrossColorLightBackground->get().toString());
+            bgCrossColor = UBSettings::settings()->boardCrossColorLightBackground->getColor();
         if (mZoomFactor < 0.7)
         {
             int alpha = 255 * mZoomFactor / 2;
@@ -2960,40 +3189,10 @@ void UBGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
         }
 
         qreal gridSize = backgroundGridSize();
-        painter->setPen (bgCrossColor);
 
         if (mPageBackground == UBPageBackground::crossed)
         {
-            qreal firstY = ((int) (rect.y () / gridSize)) * gridSize;
-
-            for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSize)
-            {
-                painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-            }
-
-            qreal firstX = ((int) (rect.x () / gridSize)) * gridSize;
-
-            for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSize)
-            {
-                painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
-            }
-
-            if (mIntermediateLines)
-            {
-                QColor intermediateColor = bgCrossColor;
-                intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
-                painter->setPen(intermediateColor);
-
-                for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
-                {
-                    painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                }
-
-                for (qreal xPos = firstX - gridSize/2; xPos < rect.x () + rect.width (); xPos += gridSize)
-                {
-                    painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
-                }
-            }
+            UBBackgroundRenderer::draw(painter, rect, UBBackgroundRenderer::Crossed, gridSize, mIntermediateLines, bgCrossColor);
         }
 
         else if (mPageBackground == UBPageBackground::ruled)
@@ -3003,70 +3202,64 @@ void UBGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
                 qreal gridSizeSeyes = gridSize * 2; // The grid size must be bigger
                 int nbMarginCase = 1; // a small left margin of one gridSize
 
-                QPen seyesSquare ("#8e7cc3");
-                seyesSquare.setWidthF (2.);
+                // Vertical lines start after the margin. The left half of the first one is drawn
+                // by the area on its right, so the split is half a case before it.
 
-                QColor interlineColor("#6fa8dc");
-                interlineColor.setAlphaF(0.6);
-                QPen interlinePen(interlineColor);
-                interlinePen.setWidthF(2.);
+                qreal firstX = ((int) (nbMarginCase + 1) * gridSizeSeyes) - mNominalSize.width() / 2.;
+                qreal split = firstX - gridSizeSeyes / 2;
 
-                QPen redLineMargin(QColor("red"));
-                redLineMargin.setWidthF(2.);
+                QRectF marginRect = rect.intersected(QRectF(rect.x(), rect.y(), split - rect.x(), rect.height()));
+                QRectF pageRect = rect.intersected(QRectF(split, rect.y(), rect.x() + rect.width() - split, rect.height()));
 
-                // Horizontal lines
+                if (marginRect.isValid())
+                    UBBackgroundRenderer::draw(painter, marginRect, UBBackgroundRenderer::SeyesHorizontal, gridSize, false, bgCrossColor);
 
-                qreal firstY = ((int) (rect.y () / gridSizeSeyes)) * gridSizeSeyes;
-
-                for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += gridSizeSeyes)
-                {
-                    painter->setPen (seyesSquare);
-                    painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                    painter->setPen (interlinePen);
-                    painter->drawLine (rect.x (), yPos+gridSizeSeyes/4, rect.x () + rect.width (), yPos+gridSizeSeyes/4);
-                    painter->drawLine (rect.x (), yPos+2*gridSizeSeyes/4, rect.x () + rect.width (), yPos+2*gridSizeSeyes/4);
-                    painter->drawLine (rect.x (), yPos+3*gridSizeSeyes/4, rect.x () + rect.width (), yPos+3*gridSizeSeyes/4);
-                }
+                if (pageRect.isValid())
+                    UBBackgroundRenderer::draw(painter, pageRect, UBBackgroundRenderer::Seyes, gridSize, false, bgCrossColor, QPointF(firstX, 0));
 
                 // Vertical margin
 
-                qreal firstX = ((int) nbMarginCase * gridSizeSeyes) - mNominalSize.width() / 2.;
+                qreal marginX = ((int) nbMarginCase * gridSizeSeyes) - mNominalSize.width() / 2.;
 
-                painter->setPen(redLineMargin);
-                painter->drawLine (firstX, rect.y (), firstX, rect.y () + rect.height ());
-
-                // Vertical lines
-
-                firstX = ((int) (nbMarginCase + 1) * gridSizeSeyes) - mNominalSize.width() / 2.;
-
-                painter->setPen (seyesSquare);
-                for (qreal xPos = firstX; xPos < rect.x () + rect.width (); xPos += gridSizeSeyes)
-                {
-                    painter->drawLine (xPos, rect.y (), xPos, rect.y () + rect.height ());
-                }
+                painter->setPen(UBBackgroundRenderer::seyesMarginPen());
+                painter->drawLine (marginX, rect.y (), marginX, rect.y () + rect.height ());
             }
             else
             {
-                qreal firstY = ((int) (rect.y () / backgroundGridSize())) * backgroundGridSize();
-
-                for (qreal yPos = firstY; yPos < rect.y () + rect.height (); yPos += backgroundGridSize())
-                {
-                    painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                }
-
-                if (mIntermediateLines) {
-                    QColor intermediateColor = bgCrossColor;
-                    intermediateColor.setAlphaF(0.5 * bgCrossColor.alphaF());
-                    painter->setPen(intermediateColor);
-
-                    for (qreal yPos = firstY - gridSize/2; yPos < rect.y () + rect.height (); yPos += gridSize)
-                    {
-                        painter->drawLine (rect.x (), yPos, rect.x () + rect.width (), yPos);
-                    }
-                }
+                UBBackgroundRenderer::draw(painter, rect, UBBackgroundRenderer::Ruled, gridSize, mIntermediateLines, bgCrossColor);
             }
         }
     }
+
+    drawBackgroundObject(painter, rect);
+}
+
+void UBGraphicsScene::drawBackgroundObject(QPainter *painter, const QRectF &rect)
+{
+    // PDF pages are merged from the original document when exporting
+    if (!mBackgroundObject
+            || mBackgroundObject->scene() != this
+            || !mBackgroundObject->isVisible()
+            || (mRenderingContext == PdfExport && qgraphicsitem_cast<UBGraphicsPDFItem*>(mBackgroundObject)))
+    {
+        return;
+    }
+
+    QRectF exposedRect = mBackgroundObject->mapRectFromScene(rect) & mBackgroundObject->boundingRect();
+
+    if (exposedRect.isEmpty())
+        return;
+
+    QStyleOptionGraphicsItem option;
+    option.state = QStyle::State_None;
+    option.rect = mBackgroundObject->boundingRect().toAlignedRect();
+    option.exposedRect = exposedRect;
+
+    painter->save();
+    painter->setTransform(mBackgroundObject->sceneTransform(), true);
+    painter->setOpacity(mBackgroundObject->effectiveOpacity());
+    mBackgroundObject->paint(painter, &option, nullptr);
+    painter->restore();
 }
 
 void UBGraphicsScene::keyReleaseEvent(QKeyEvent * keyEvent)
@@ -3181,7 +3374,7 @@ void UBGraphicsScene::updateBackground()
 
 void UBGraphicsScene::createEraiser()
 {
-    if (UBSettings::settings()->showEraserPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showEraserPreviewCircle->getBool()) {
         mEraser = new QGraphicsEllipseItem(); // mem : owned and destroyed by the scene
         mEraser->setRect(QRect(0, 0, 0, 0));
         mEraser->setVisible(false);
@@ -3214,7 +3407,7 @@ void UBGraphicsScene::createPointer()
 
 void UBGraphicsScene::createMarkerCircle()
 {
-    if (UBSettings::settings()->showMarkerPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showMarkerPreviewCircle->getBool()) {
         mMarkerCircle = new QGraphicsEllipseItem();
 
         mMarkerCircle->setRect(QRect(0, 0, 0, 0));
@@ -3233,7 +3426,7 @@ void UBGraphicsScene::createMarkerCircle()
 
 void UBGraphicsScene::createPenCircle()
 {
-    if (UBSettings::settings()->showPenPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showPenPreviewCircle->getBool()) {
         mPenCircle = new QGraphicsEllipseItem();
 
         mPenCircle->setRect(QRect(0, 0, 0, 0));
@@ -103,10 +103,25 @@ public:
 
     bool zLevelAvailable(QGraphicsItem* item);
 
+    // ordered per-layer index of the scene items, maintained by UBGraphicsScene
+    void addItem(QGraphicsItem *item);
+    void removeItem(QGraphicsItem *item);
+    void updateItem(QGraphicsItem *item);
+    void clearItems();
+
+    void renumberLayer(itemLayerType::Enum key, QGraphicsItem *lowestItem = 0);
+
 private:
+    typedef QMultiMap<qreal, QGraphicsItem*> LayerItems;
+    typedef QPair<itemLayerType::Enum, qreal> LayerPosition;
+
     ScopeMap scopeMap;
     static qreal errorNumber;
     QGraphicsScene *mScene;
+
+    // items of each layer sorted by their own z value, and the key under which each item is stored
+    QMap<itemLayerType::Enum, LayerItems> mLayerItems;
+    QHash<QGraphicsItem*, LayerPosition> mItemPositions;
 };
 
 class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::enable_shared_from_this<UBGraphicsScene>
@@ -151,6 +166,13 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
         void addItems(const QSet<QGraphicsItem*>& item);
         void removeItems(const QSet<QGraphicsItem*>& item);
 
+        /**
+         * Suspend the item index while many items are added or removed at once. Calls can be
+         * nested, the index is rebuilt once when the outermost bulk change ends.
+         */
+        void beginBulkChange();
+        void endBulkChange();
+
         UBGraphicsWidgetItem* addWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
         UBGraphicsAppleWidgetItem* addAppleWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
         UBGraphicsW3CWidgetItem* addW3CWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
@@ -180,6 +202,12 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
             return mBackgroundObject;
         }
 
+        /**
+         * The background object is drawn with the page background, so each view keeps it in its
+         * background cache. Call this when its content or geometry changed.
+         */
+        void invalidateBackgroundObject();
+
         bool isBackgroundObject(const QGraphicsItem* item) const
         {
             return item == mBackgroundObject;
@@ -191,6 +219,10 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
 
         QGraphicsItem *itemForUuid(QUuid uuid);
 
+        // keeps the item indexes up to date when an item enters or leaves a scene through its parent,
+        // to call on QGraphicsItem::ItemSceneHasChanged
+        static void itemSceneHasChanged(QGraphicsItem *item);
+
         void moveTo(const QPointF& pPoint);
         void drawLineTo(const QPointF& pEndPoint, const qreal& pWidth, bool bLineStyle);
         void drawLineTo(const QPointF& pEndPoint, const qreal& pStartWidth, const qreal& endWidth, bool bLineStyle);
@@ -404,6 +436,10 @@ public slots:
 signals:
         void zoomChanged(qreal zoomFactor);
 
+        // a stroke polygon entered or left the scene, directly or through its strokes group
+        void polygonItemAdded(QGraphicsItem* item);
+        void polygonItemRemoved(QGraphicsItem* item);
+
     protected:
 
         UBGraphicsPolygonItem* lineToPolygonItem(const QLineF& pLine, const qreal& pWidth);
@@ -437,6 +473,7 @@ signals:
         QGraphicsItem* rootItem(QGraphicsItem* item) const;
 
         virtual void drawBackground(QPainter *painter, const QRectF &rect);
+        void drawBackgroundObject(QPainter *painter, const QRectF &rect);
 
 
     private:
@@ -452,6 +489,16 @@ signals:
         bool hasTextItemWithFocus(UBGraphicsGroupContainerItem* item);
         void simplifyCurrentStroke();
 
+        friend class UBItem;
+        friend class UBGraphicsItem;
+        QGraphicsItem* indexedItem(const QUuid& uuid) const;
+        void indexItem(UBItem* ubItem, QGraphicsItem* item);
+        void unindexItem(UBItem* ubItem);
+        void reindexUuid(UBItem* ubItem, const QUuid& previousUuid);
+        void reindexZLevel(QGraphicsItem* item);
+        void indexItemTree(QGraphicsItem* item, bool index);
+        void clearItemIndexes();
+
         QGraphicsEllipseItem* mEraser;
         QGraphicsEllipseItem* mPointer; // "laser" pointer
         QGraphicsEllipseItem* mMarkerCircle; // dotted circle around marker
@@ -471,6 +518,7 @@ signals:
         qreal mZoomFactor;
 
         QGraphicsItem* mBackgroundObject;
+        QRectF mBackgroundObjectRect;
 
         QPointF mPreviousPoint;
         qreal mPreviousWidth;
@@ -494,6 +542,13 @@ signals:
         UBGraphicsStroke* mCurrentStroke;
 
         int mItemCount;
+        int mBulkChangeDepth;
+
+        // items referencing this scene through UBItem::mIndexScene, and the indexes built on them:
+        // uuid -> item, updated on add, remove and uuid change, see itemForUuid(),
+        // and the z-layer index of mZLayerController
+        QHash<UBItem*, QGraphicsItem*> mIndexedItems;
+        QHash<QUuid, UBItem*> mItemsByUuid;
 
         bool mHasCache;
         //        tmp stub for divide addings scene objects from undo mechanism implementation
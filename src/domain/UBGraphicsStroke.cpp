@@ -227,10 +227,10 @@ UBGraphicsStroke* UBGraphicsStroke::simplify()
      */
 
     // angle difference in degrees between AB and BC below which the segments are considered colinear
-    qreal thresholdAngle = UBSettings::settings()->boardSimplifyPenStrokesThresholdAngle->get().toReal();
+    qreal thresholdAngle = UBSettings::settings()->boardSimplifyPenStrokesThresholdAngle->getReal();
 
     // Relative difference in thickness between two consecutive points (A and B) below which they are considered equal
-    qreal thresholdWidthDifference = UBSettings::settings()->boardSimplifyPenStrokesThresholdWidthDifference->get().toReal();
+    qreal thresholdWidthDifference = UBSettings::settings()->boardSimplifyPenStrokesThresholdWidthDifference->getReal();
 
     QList<strokePoint>::iterator it = points.begin();
     QList<QList<strokePoint>::iterator> toDelete;
@@ -37,6 +37,7 @@
 
 #include "core/UBApplication.h"
 #include "core/UBPersistenceManager.h"
+#include "core/UBMimeData.h"
 
 #include "board/UBBoardController.h"
 
@@ -44,6 +45,8 @@
 
 #include "core/memcheck.h"
 
+static const int sDragPixmapWidth = 100;
+
 UBGraphicsSvgItem::UBGraphicsSvgItem(const QString& pFilePath, QGraphicsItem* parent)
     : QGraphicsSvgItem(pFilePath, parent)
 {
@@ -112,20 +115,54 @@ QVariant UBGraphicsSvgItem::itemChange(GraphicsItemChange change, const QVariant
 
 void UBGraphicsSvgItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    QMimeData* pMime = new QMimeData();
-    QPixmap pixmap = toPixmapItem()->pixmap();
-    pMime->setImageData(pixmap.toImage());
-    Delegate()->setMimeData(pMime);
-    qreal k = (qreal)pixmap.width() / 100.0;
-
-    QSize newSize((int)(pixmap.width() / k), (int)(pixmap.height() / k));
-
-    Delegate()->setDragPixmap(pixmap.scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
     if (!Delegate()->mousePressEvent(event))
         QGraphicsSvgItem::mousePressEvent(event);
 }
 
 
+QMimeData* UBGraphicsSvgItem::dragMimeData() const
+{
+    QByteArray svgData = fileData();
+
+    // rasterized at its view box size, like toPixmapItem(), if a drop target wants the image
+    return new UBMimeDataImage([svgData]() {
+        QSvgRenderer svgRenderer(svgData);
+        QImage image(svgRenderer.viewBox().size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        svgRenderer.render(&painter);
+
+        return image;
+    });
+}
+
+QPixmap UBGraphicsSvgItem::dragPixmap() const
+{
+    QSize size = renderer()->viewBox().size();
+
+    if (size.isEmpty())
+        return QPixmap();
+
+    // the preview is rendered at its final size, never from a full size rasterization
+    QString key = QString("UBDragSvg-%1").arg(uuid().toString());
+    QPixmap preview;
+
+    if (!QPixmapCache::find(key, &preview))
+    {
+        preview = QPixmap(sDragPixmapWidth, qMax(1, sDragPixmapWidth * size.height() / size.width()));
+        preview.fill(Qt::transparent);
+
+        QPainter painter(&preview);
+        renderer()->render(&painter);
+        painter.end();
+
+        QPixmapCache::insert(key, preview);
+    }
+
+    return preview;
+}
+
 void UBGraphicsSvgItem::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
     if (Delegate()->mouseMoveEvent(event))
@@ -78,6 +78,10 @@ class UBGraphicsSvgItem: public QGraphicsSvgItem, public UBItem, public UBGraphi
 
         virtual void clearSource();
 
+        virtual bool isDragSource() const { return true; }
+        virtual QMimeData* dragMimeData() const;
+        virtual QPixmap dragPixmap() const;
+
     protected:
 
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
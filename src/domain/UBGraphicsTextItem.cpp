@@ -50,12 +50,11 @@ UBGraphicsTextItem::UBGraphicsTextItem(QGraphicsItem * parent)
     , mMultiClickState(0)
     , mLastMousePressTime(QTime::currentTime())
     , isActivatedTextEditor(true)
+    , mRenderRevision(0)
 {
     setDelegate(new UBGraphicsTextItemDelegate(this, 0));
 
-    // TODO claudio remove this because in contrast with the fact the frame should be created on demand.
-    Delegate()->createControls();
-    Delegate()->frame()->setOperationMode(UBGraphicsDelegateFrame::Resizing);
+    // the frame and buttons are only created when the item gets selected
     Delegate()->setUBFlag(GF_FLIPPABLE_ALL_AXIS, false);
     Delegate()->setUBFlag(GF_REVOLVABLE, true);
 
@@ -69,7 +68,7 @@ UBGraphicsTextItem::UBGraphicsTextItem(QGraphicsItem * parent)
 
     setUuid(QUuid::createUuid());
 
-    connect(document(), SIGNAL(contentsChanged()), Delegate(), SLOT(contentsChanged()));
+    connect(document(), SIGNAL(contentsChanged()), this, SLOT(documentContentsChanged()));
     connect(document(), SIGNAL(undoCommandAdded()), this, SLOT(undoCommandAdded()));
 
     connect(document()->documentLayout(), SIGNAL(documentSizeChanged(const QSizeF &)),
@@ -162,6 +161,14 @@ QVariant UBGraphicsTextItem::itemChange(GraphicsItemChange change, const QVarian
     if(Delegate())
         newValue = Delegate()->itemChange(change, value);
 
+    // text is only interactive while selected, the press on an unselected item starts the edition
+    if ((change == QGraphicsItem::ItemSelectedHasChanged && !value.toBool())
+            || (change == QGraphicsItem::ItemSceneHasChanged && !isSelected()))
+        setTextInteractionFlags(Qt::NoTextInteraction);
+
+    if (change == QGraphicsItem::ItemSceneHasChanged)
+        mRenderCache.clear();
+
     return QGraphicsTextItem::itemChange(change, newValue);
 }
 
@@ -330,12 +337,27 @@ void UBGraphicsTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem
     styleOption.state &= ~QStyle::State_Selected;
     styleOption.state &= ~QStyle::State_HasFocus;
 
-    QGraphicsTextItem::paint(painter, &styleOption, widget);
+    bool isControlView = widget == UBApplication::boardController->controlView()->viewport();
 
-    if (widget == UBApplication::boardController->controlView()->viewport() && !isSelected())
+    if (isControlView && !isEditing())
     {
-        setTextInteractionFlags(Qt::NoTextInteraction);
-        if (toPlainText().isEmpty())
+        // the whole item is rendered once in the cached layer, not only the exposed part
+        styleOption.exposedRect = boundingRect();
+
+        QString key = QString("%1|%2").arg(mRenderRevision).arg(defaultTextColor().rgba());
+
+        mRenderCache.paint(painter, boundingRect(), key, [&](QPainter* layerPainter) {
+            QGraphicsTextItem::paint(layerPainter, &styleOption, widget);
+        });
+    }
+    else
+    {
+        QGraphicsTextItem::paint(painter, &styleOption, widget);
+    }
+
+    if (isControlView && !isSelected())
+    {
+        if (document()->isEmpty())
         {
             painter->setFont(font());
             painter->setPen(UBSettings::paletteColor);
@@ -412,7 +434,15 @@ void UBGraphicsTextItem::setTextHeight(qreal height)
 {
     QFontMetrics fm(font());
     qreal minHeight = fm.height() + document()->documentMargin() * 2;
-    mTextHeight = qMax(minHeight, height);
+    qreal newHeight = qMax(minHeight, height);
+
+    if (newHeight != mTextHeight)
+    {
+        // the bounding rect depends on the text height
+        prepareGeometryChange();
+        mTextHeight = newHeight;
+    }
+
     update();
     setFocus();
 }
@@ -457,6 +487,21 @@ qreal UBGraphicsTextItem::pixelsPerPoint() const
 }
 
 
+bool UBGraphicsTextItem::isEditing()
+{
+    // the cursor and the selection are drawn by the text control and can't be cached
+    return hasFocus() || textCursor().hasSelection();
+}
+
+void UBGraphicsTextItem::documentContentsChanged()
+{
+    mRenderRevision++;
+
+    // a document without undo history was only loaded or laid out, there is nothing to save
+    if (document()->availableUndoSteps() > 0 || document()->availableRedoSteps() > 0)
+        contentsChanged();
+}
+
 void UBGraphicsTextItem::contentsChanged()
 {
     if (scene())
@@ -512,7 +557,7 @@ void UBGraphicsTextItem::activateTextEditor(bool activate)
     this->isActivatedTextEditor = activate;
 
     if(!activate){
-        setTextInteractionFlags(Qt::TextSelectableByMouse);
+        setTextInteractionFlags(isSelected() ? Qt::TextSelectableByMouse : Qt::NoTextInteraction);
     }else{
         setTextInteractionFlags(Qt::TextEditorInteraction);
     }
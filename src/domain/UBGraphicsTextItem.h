@@ -34,6 +34,7 @@
 #include "UBItem.h"
 #include "core/UB.h"
 #include "UBResizableGraphicsItem.h"
+#include "tools/UBToolLayerCache.h"
 
 class UBGraphicsItemDelegate;
 class UBGraphicsScene;
@@ -112,6 +113,7 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
     private slots:
         void undoCommandAdded();
         void documentSizeChanged(const QSizeF & newSize);
+        void documentContentsChanged();
 
     private:
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -127,6 +129,8 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
 
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
+        bool isEditing();
+
         qreal mTextHeight;
 
         int mMultiClickState;
@@ -135,6 +139,10 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
         QColor mColorOnDarkBackground;
         QColor mColorOnLightBackground;
         bool isActivatedTextEditor;
+
+        // raster of the text when it is not edited, invalidated by each document change
+        UBToolLayerCache mRenderCache;
+        int mRenderRevision;
 };
 
 #endif /* UBGRAPHICSTEXTITEM_H_ */
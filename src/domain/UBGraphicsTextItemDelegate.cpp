@@ -51,10 +51,10 @@ const int UBGraphicsTextItemDelegate::sMinPointSize = 8;
 
 AlignTextButton::AlignTextButton(const QString &fileName, QGraphicsItem *pDelegated, QGraphicsItem *parent, Qt::WindowFrameSection section)
     : DelegateButton(fileName, pDelegated, parent, section)
-    , lft(new QSvgRenderer(QString(":/images/leftAligned.svg")))
-    , cntr(new QSvgRenderer(QString(":/images/centerAligned.svg")))
-    , rght(new QSvgRenderer(QString(":/images/rightAligned.svg")))
-    , mxd(new QSvgRenderer(QString(":/images/notAligned.svg")))
+    , lft(sharedRenderer(":/images/leftAligned.svg"))
+    , cntr(sharedRenderer(":/images/centerAligned.svg"))
+    , rght(sharedRenderer(":/images/rightAligned.svg"))
+    , mxd(sharedRenderer(":/images/notAligned.svg"))
     , mHideMixed(true)
 {
     setKind(k_left);
@@ -62,10 +62,7 @@ AlignTextButton::AlignTextButton(const QString &fileName, QGraphicsItem *pDelega
 
 AlignTextButton::~AlignTextButton()
 {
-    if (lft) delete lft;
-    if (cntr) delete cntr;
-    if (rght) delete rght;
-    if (mxd) delete mxd;
+    // NOOP, the renderers are shared
 }
 
 void AlignTextButton::setKind(int pKind)
@@ -88,10 +88,10 @@ private:
 
     QSvgRenderer *curRnd() {return rndFromKind(mKind);}
 
-    QPointer<QSvgRenderer> lft;
-    QPointer<QSvgRenderer> cntr;
-    QPointer<QSvgRenderer> rght;
-    QPointer<QSvgRenderer> mxd;
+    QSvgRenderer* lft;
+    QSvgRenderer* cntr;
+    QSvgRenderer* rght;
+    QSvgRenderer* mxd;
 
     int mKind;
     bool mHideMixed;
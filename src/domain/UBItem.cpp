@@ -45,13 +45,24 @@
 UBItem::UBItem()
     : mUuid(QUuid::createUuid())
     , mRenderingQuality(UBItem::RenderingQualityNormal)
+    , mIndexScene(nullptr)
 {
     // NOOP
 }
 
 UBItem::~UBItem()
 {
-    // NOOP
+    if (mIndexScene)
+        mIndexScene->unindexItem(this);
+}
+
+void UBItem::setUuid(const QUuid& pUuid)
+{
+    QUuid previousUuid = mUuid;
+    mUuid = pUuid;
+
+    if (mIndexScene)
+        mIndexScene->reindexUuid(this, previousUuid);
 }
 
 UBGraphicsItem::~UBGraphicsItem()
@@ -75,6 +86,11 @@ void UBGraphicsItem::assignZValue(QGraphicsItem *item, qreal value)
 {
     item->setZValue(value);
     item->setData(UBGraphicsItemData::ItemOwnZValue, value);
+
+    UBGraphicsScene *scene = dynamic_cast<UBGraphicsScene*>(item->scene());
+
+    if (scene)
+        scene->reindexZLevel(item);
 }
 
 bool UBGraphicsItem::isFlippable(QGraphicsItem *item)
@@ -99,8 +115,7 @@ bool UBGraphicsItem::isHiddenOnDisplay(QGraphicsItem *item)
 
 QUuid UBGraphicsItem::getOwnUuid(QGraphicsItem *item)
 {
-    QString idCandidate = item->data(UBGraphicsItemData::ItemUuid).toString();
-    return idCandidate == QUuid().toString() ? QUuid() : QUuid(idCandidate);
+    return item->data(UBGraphicsItemData::ItemUuid).toUuid();
 }
 
 void UBGraphicsItem::remove(bool canUndo)
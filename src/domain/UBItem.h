@@ -63,10 +63,7 @@ class UBItem
                 return mUuid;
         }
 
-        virtual void setUuid(const QUuid& pUuid)
-        {
-                mUuid = pUuid;
-        }
+        virtual void setUuid(const QUuid& pUuid);
 
         virtual RenderingQuality renderingQuality() const
         {
@@ -111,6 +108,12 @@ class UBItem
         QUrl mSourceUrl;
 
         CacheBehavior mCacheBehavior;
+
+    private:
+        friend class UBGraphicsScene;
+
+        // scene whose item indexes reference this item, kept up to date by UBGraphicsScene
+        UBGraphicsScene* mIndexScene;
 };
 
 class UBGraphicsItem
@@ -141,6 +144,14 @@ public:
 
     virtual void clearSource(){}
 
+    /**
+     * Items returning true are dragged out of the board when they are moved past the drag
+     * distance. The payload is only built then, from dragMimeData() and dragPixmap().
+     */
+    virtual bool isDragSource() const { return false; }
+    virtual QMimeData* dragMimeData() const { return nullptr; }
+    virtual QPixmap dragPixmap() const { return QPixmap(); }
+
 private:
     UBGraphicsItemDelegate* mDelegate;
 };
@@ -264,7 +264,6 @@ void UBSelectionFrame::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
             ownTransform.rotate(-dAngle);
             ownTransform.translate(-cntrX, -cntrY);
 
-            item->update();
             item->setTransform(ownTransform, false);
 
         } break;
@@ -294,6 +293,8 @@ void UBSelectionFrame::mouseReleaseEvent(QGraphicsSceneMouseEvent */*event*/)
 
 void UBSelectionFrame::onZoomChanged(qreal pZoom)
 {
+    // the frame thickness, and so the bounding rect, follows the anti-scale ratio
+    prepareGeometryChange();
     mAntiscaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * pZoom);
 
     placeButtons();
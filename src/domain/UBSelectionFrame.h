@@ -66,7 +66,7 @@ protected:
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
 
 private slots:
-    void setAntiScaleRatio(qreal pAntiscaleRatio) {mAntiscaleRatio = pAntiscaleRatio;}
+    void setAntiScaleRatio(qreal pAntiscaleRatio) {prepareGeometryChange(); mAntiscaleRatio = pAntiscaleRatio;}
     void onZoomChanged(qreal pZoom);
     void remove();
     void duplicate();
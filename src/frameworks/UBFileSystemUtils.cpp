@@ -30,6 +30,9 @@
 #include "UBFileSystemUtils.h"
 
 #include <QtGui>
+#include <QtConcurrent>
+
+#include <zlib.h>
 
 #include "core/UBApplication.h"
 
@@ -47,6 +50,153 @@ THIRD_PARTY_WARNINGS_ENABLE
 
 QStringList UBFileSystemUtils::sTempDirToCleanUp;
 
+namespace
+{
+    // size of the buffers used to stream archive entries, whatever their size
+    const qint64 zipBufferSize = 256 * 1024;
+
+    // larger entries are deflated in place instead of being buffered in memory
+    const qint64 maxParallelDeflateSize = 16 * 1024 * 1024;
+
+    struct UBZipEntry
+    {
+        QString filePath;
+        QString zipPath;
+        QString objectType;
+        int progressIndex = -1;
+        int progressTotal = 0;
+        bool store = false;
+        bool parallel = false;
+    };
+
+    struct UBDeflatedZipEntry
+    {
+        QByteArray data;
+        quint32 crc = 0;
+        qint64 size = 0;
+        bool ok = false;
+    };
+
+    bool isAlreadyCompressed(const QFileInfo& pFileInfo)
+    {
+        static const QStringList compressedExtensions = QStringList()
+                << "jpg" << "jpeg" << "png" << "gif" << "webp"
+                << "mp3" << "m4a" << "aac" << "ogg" << "oga" << "opus"
+                << "mp4" << "m4v" << "mov" << "webm" << "mkv" << "avi" << "ogv" << "flv" << "wmv"
+                << "pdf" << "zip" << "ubz" << "gz" << "7z";
+
+        return compressedExtensions.contains(pFileInfo.suffix(), Qt::CaseInsensitive);
+    }
+
+    void collectZipEntries(const QDir& pDir, const QString& pDestPath, bool pRootDocumentFolder, bool pReportProgress, QList<UBZipEntry>& pEntries)
+    {
+        QFileInfoList files = pDir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
+
+        QStringList filters;
+        filters << "*.svg";
+        QFileInfoList pageFiles = pDir.entryInfoList(filters);
+
+        for (int i = 0; i < files.size(); i++)
+        {
+            const QFileInfo& file = files.at(i);
+
+            if (file.isDir())
+            {
+                QDir dir(file.absoluteFilePath());
+                collectZipEntries(dir, pDestPath + dir.dirName() + "/", false, false, pEntries);
+            }
+
+            if (file.isFile())
+            {
+                UBZipEntry entry;
+                entry.filePath = file.absoluteFilePath();
+                entry.zipPath = pDestPath + file.fileName();
+                entry.objectType = pRootDocumentFolder ? QString("Page") : pDir.dirName();
+
+                if (pReportProgress && !pRootDocumentFolder)
+                {
+                    entry.progressIndex = i;
+                    entry.progressTotal = files.size();
+                }
+                // we ignore thumbnails message because it is very fast.
+                else if (pReportProgress && file.suffix() == "svg")
+                {
+                    entry.progressIndex = pageFiles.indexOf(file);
+                    entry.progressTotal = pageFiles.size();
+                }
+
+                entry.store = isAlreadyCompressed(file);
+                entry.parallel = !entry.store && file.size() <= maxParallelDeflateSize;
+
+                pEntries << entry;
+            }
+        }
+    }
+
+    UBDeflatedZipEntry deflateFile(const QString& pFilePath)
+    {
+        UBDeflatedZipEntry entry;
+
+        QFile inFile(pFilePath);
+        if (!inFile.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Compression of file" << pFilePath << " failed. Cause: inFile.open(): " << inFile.errorString();
+            return entry;
+        }
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+
+        // raw deflate stream, the zip headers are written by QuaZip
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return entry;
+        }
+
+        entry.data.reserve(static_cast<int>(deflateBound(&stream, static_cast<uLong>(inFile.size()))));
+
+        QByteArray inBuffer(zipBufferSize, Qt::Uninitialized);
+        QByteArray outBuffer(zipBufferSize, Qt::Uninitialized);
+        uLong crc = crc32(0L, Z_NULL, 0);
+        int status = Z_OK;
+        int flush = Z_NO_FLUSH;
+
+        do
+        {
+            qint64 read = inFile.read(inBuffer.data(), zipBufferSize);
+            if (read < 0)
+            {
+                qWarning() << "Compression of file" << pFilePath << " failed. Cause: inFile.read(): " << inFile.errorString();
+                deflateEnd(&stream);
+                return entry;
+            }
+
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(inBuffer.constData()), static_cast<uInt>(read));
+            entry.size += read;
+
+            flush = inFile.atEnd() ? Z_FINISH : Z_NO_FLUSH;
+            stream.next_in = reinterpret_cast<Bytef*>(inBuffer.data());
+            stream.avail_in = static_cast<uInt>(read);
+
+            do
+            {
+                stream.next_out = reinterpret_cast<Bytef*>(outBuffer.data());
+                stream.avail_out = static_cast<uInt>(zipBufferSize);
+                status = deflate(&stream, flush);
+                entry.data.append(outBuffer.constData(), zipBufferSize - stream.avail_out);
+            } while (stream.avail_out == 0);
+
+        } while (flush != Z_FINISH);
+
+        deflateEnd(&stream);
+
+        entry.crc = static_cast<quint32>(crc);
+        entry.ok = status == Z_STREAM_END;
+
+        return entry;
+    }
+}
+
 
 UBFileSystemUtils::UBFileSystemUtils()
 {
@@ -657,82 +807,93 @@ QString UBFileSystemUtils::getFirstExistingFileFromList(const QString& path, con
 
 bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestPath, QuaZipFile *pOutZipFile, bool pRootDocumentFolder, UBProcessingProgressListener* progressListener)
 {
-    QFileInfoList files = pDir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
+    QList<UBZipEntry> entries;
+    collectZipEntries(pDir, pDestPath, pRootDocumentFolder, progressListener != nullptr, entries);
 
-    QStringList filters;
-    filters << "*.svg";
-    QFileInfoList pageFiles = pDir.entryInfoList(filters);
+    // independent entries are deflated ahead on the thread pool while the archive is
+    // written sequentially, in the same order as before. The window bounds the memory used.
+    const int window = qMax(2, 2 * QThread::idealThreadCount());
+    QVector<QFuture<UBDeflatedZipEntry>> deflatedEntries(entries.size());
+    int nextToDeflate = 0;
 
-    foreach (QFileInfo file, files)
+    for (int i = 0; i < entries.size(); i++)
     {
-        if (file.isDir())
+        for (; nextToDeflate < entries.size() && nextToDeflate < i + window; nextToDeflate++)
         {
-            QDir dir(file.absoluteFilePath());
-            if (!compressDirInZip(dir, pDestPath + dir.dirName() + "/" , pOutZipFile, false))
+            if (entries.at(nextToDeflate).parallel)
             {
-                return false;
+                deflatedEntries[nextToDeflate] = QtConcurrent::run(deflateFile, entries.at(nextToDeflate).filePath);
             }
         }
 
-        if (file.isFile())
+        const UBZipEntry& entry = entries.at(i);
+
+        if (progressListener && entry.progressIndex >= 0)
+            progressListener->processing(entry.objectType, entry.progressIndex, entry.progressTotal);
+
+        QuaZipNewInfo newInfo(entry.zipPath, entry.filePath);
+
+        if (entry.parallel)
         {
-            QString objectType;
-            if (pRootDocumentFolder)
-            {
-                objectType = "Page";
-            }
-            else
-            {
-                objectType = pDir.dirName();
-            }
+            UBDeflatedZipEntry deflated = deflatedEntries[i].result();
+            deflatedEntries[i] = QFuture<UBDeflatedZipEntry>();
 
-            if (!pRootDocumentFolder)
+            if (!deflated.ok)
             {
-                if (progressListener)
-                    progressListener->processing(objectType, files.indexOf(file), files.size());
+                qWarning() << "Compression of file" << entry.filePath << " failed. Cause: deflate()";
+                return false;
             }
-            // we ignore thumbnails message because it is very fast.
-            else if (progressListener && file.suffix() == "svg")
+
+            newInfo.uncompressedSize = deflated.size;
+
+            if(!pOutZipFile->open(QIODevice::WriteOnly, newInfo, nullptr, deflated.crc, Z_DEFLATED, Z_DEFAULT_COMPRESSION, true))
             {
-                progressListener->processing(objectType, pageFiles.indexOf(file), pageFiles.size());
+                qWarning() << "Compression of file" << entry.filePath << " failed. Cause: outFile.open(): " << pOutZipFile->getZipError();
+                return false;
             }
 
-            QFile inFile(file.absoluteFilePath());
+            pOutZipFile->write(deflated.data);
+        }
+        else
+        {
+            QFile inFile(entry.filePath);
             if(!inFile.open(QIODevice::ReadOnly))
             {
                 qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: inFile.open(): " << inFile.errorString();
                 return false;
             }
 
-            qDebug() << "will open" << pDestPath << file.fileName() << inFile.fileName();
+            // already compressed media are only stored, deflating them again is wasted time
+            int method = entry.store ? 0 : Z_DEFLATED;
+            int level = entry.store ? 0 : Z_DEFAULT_COMPRESSION;
 
-            if(!pOutZipFile->open(QIODevice::WriteOnly, QuaZipNewInfo(pDestPath + file.fileName(), inFile.fileName())))
+            if(!pOutZipFile->open(QIODevice::WriteOnly, newInfo, nullptr, 0, method, level))
             {
                 qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: outFile.open(): " << pOutZipFile->getZipError();
-                inFile.close();
                 return false;
             }
 
-            pOutZipFile->write(inFile.readAll());
-            if(pOutZipFile->getZipError() != UNZ_OK)
+            if (!copyStream(inFile, *pOutZipFile))
             {
-                qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: outFile.write(): " << pOutZipFile->getZipError();
-
-                inFile.close();
+                qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: copyStream(): " << inFile.errorString();
                 pOutZipFile->close();
                 return false;
             }
+        }
 
-            pOutZipFile->close();
-            if(pOutZipFile->getZipError() != UNZ_OK)
-            {
-                qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: outFile.close(): " << pOutZipFile->getZipError();
+        if(pOutZipFile->getZipError() != UNZ_OK)
+        {
+            qWarning() << "Compression of file" << entry.filePath << " failed. Cause: outFile.write(): " << pOutZipFile->getZipError();
 
-                inFile.close();
-                return false;
-            }
+            pOutZipFile->close();
+            return false;
+        }
 
-            inFile.close();
+        pOutZipFile->close();
+        if(pOutZipFile->getZipError() != UNZ_OK)
+        {
+            qWarning() << "Compression of file" << entry.filePath << " failed. Cause: outFile.close(): " << pOutZipFile->getZipError();
+            return false;
         }
     }
 
@@ -740,6 +901,26 @@ bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestP
 }
 
 
+bool UBFileSystemUtils::copyStream(QIODevice& pSource, QIODevice& pDestination)
+{
+    QByteArray buffer(zipBufferSize, Qt::Uninitialized);
+
+    forever
+    {
+        qint64 read = pSource.read(buffer.data(), buffer.size());
+
+        if (read < 0)
+            return false;
+
+        if (read == 0)
+            return true;
+
+        if (pDestination.write(buffer.constData(), read) != read)
+            return false;
+    }
+}
+
+
 
 bool UBFileSystemUtils::expandZipToDir(const QFile& pZipFile, const QDir& pTargetDir)
 {
@@ -761,7 +942,6 @@ bool UBFileSystemUtils::expandZipToDir(const QFile& pZipFile, const QDir& pTarge
         pTargetDir.mkpath(documentRootFolder);
 
     QFile out;
-    char c;
     for(bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
     {
         if(!zip.getCurrentFileInfo(&info))
@@ -789,22 +969,18 @@ bool UBFileSystemUtils::expandZipToDir(const QFile& pZipFile, const QDir& pTarge
         root.mkpath(newFileInfo.absolutePath());
 
         out.setFileName(newFileName);
-        out.open(QIODevice::WriteOnly);
-
-        // Slow like hell (on GNU/Linux at least), but it is not my fault.
-        // Not ZIP/UNZIP package's fault either.
-        // The slowest thing here is out.putChar(c).
-        QByteArray outFileContent = file.readAll();
-        if (out.write(outFileContent) == -1)
+        if (out.open(QIODevice::WriteOnly))
         {
-            // qWarning() << "ZIP expand failed. Cause: Unable to write file";
-            // this may happen if we are decompressing a directory
-        }
-
-        while(file.getChar(&c))
-            out.putChar(c);
+            if (!copyStream(file, out))
+            {
+                qWarning() << "ZIP expand failed. Cause: Unable to write file" << newFileName;
+                out.close();
+                return false;
+            }
 
-        out.close();
+            out.close();
+        }
+        // else this may happen if we are decompressing a directory
 
         if(file.getZipError()!= UNZ_OK)
         {
@@ -97,6 +97,7 @@ class UBFileSystemUtils : public QObject
         static bool deleteFile(const QString &path);
         /**
          * Compress a source directory in a zip file.
+         * Small entries are deflated in parallel, already compressed media (JPEG, PNG, MP4, PDF...) are stored.
          * @arg pDir the directory to add in zip
          * @arg pDestPath the path inside the zip. Attention, if path is not empty it must end by a /.
          * @arg pOutZipFile the zip file we want to populate with the directory
@@ -108,6 +109,12 @@ class UBFileSystemUtils : public QObject
 
         static bool expandZipToDir(const QFile& pZipFile, const QDir& pTargetDir);
 
+        /**
+         * Copy the remaining content of a device into another one using a fixed-size buffer.
+         * @return bool. true if all the data could be read and written.
+         */
+        static bool copyStream(QIODevice& pSource, QIODevice& pDestination);
+
         static QString nextAvailableFileName(const QString& filename, const QString& inter = QString(""));
 
         static QString readTextFile(QString path);
@@ -195,6 +195,11 @@ public:
         static QString applicationTemplateDirectory();
         static void hideFile(const QString &filePath);
         static void setFileType(const QString &filePath, unsigned long fileType);
+        /**
+         * Create destination without copying the data of source: copy-on-write clone where the
+         * file system supports it, hard link if allowed. Returns false if a regular copy is needed.
+         */
+        static bool linkFile(const QString &sourcePath, const QString &destinationPath, bool allowHardLink);
         static void fadeDisplayOut();
         static void fadeDisplayIn();
         static QString translationPath(QString pFilePrefix, QString pLanguage);
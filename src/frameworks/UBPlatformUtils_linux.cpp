@@ -35,6 +35,9 @@
 #include <QProcessEnvironment>
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 #include <X11/keysym.h>
 
 #include "frameworks/UBFileSystemUtils.h"
@@ -97,6 +100,38 @@ void UBPlatformUtils::hideFile(const QString &filePath)
     // TODO UB 4.x Not possible on Linux as such, the filename should have a . as first char in name
 }
 
+bool UBPlatformUtils::linkFile(const QString &sourcePath, const QString &destinationPath, bool allowHardLink)
+{
+    QByteArray source = QFile::encodeName(sourcePath);
+    QByteArray destination = QFile::encodeName(destinationPath);
+
+#ifdef FICLONE
+    // reflink on copy-on-write file systems (btrfs, xfs, ...)
+    int sourceFd = ::open(source.constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd >= 0)
+    {
+        int destinationFd = ::open(destination.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (destinationFd >= 0)
+        {
+            bool cloned = ::ioctl(destinationFd, FICLONE, sourceFd) == 0;
+            ::close(destinationFd);
+            ::close(sourceFd);
+
+            if (cloned)
+                return true;
+
+            ::unlink(destination.constData());
+        }
+        else
+        {
+            ::close(sourceFd);
+        }
+    }
+#endif
+
+    return allowHardLink && ::link(source.constData(), destination.constData()) == 0;
+}
+
 void UBPlatformUtils::setFileType(const QString &filePath, unsigned long fileType)
 {
     Q_UNUSED(filePath)
@@ -37,6 +37,9 @@
 #include <QWidget>
 #include <QRegularExpression>
 
+#include <sys/clonefile.h>
+#include <unistd.h>
+
 #import <Foundation/NSAutoreleasePool.h>
 #import <Cocoa/Cocoa.h>
 #import <Carbon/Carbon.h>
@@ -133,6 +136,18 @@ QString UBPlatformUtils::applicationTemplateDirectory()
     return applicationResourcesDirectory() + "/etc";
 }
 
+bool UBPlatformUtils::linkFile(const QString &sourcePath, const QString &destinationPath, bool allowHardLink)
+{
+    QByteArray source = QFile::encodeName(sourcePath);
+    QByteArray destination = QFile::encodeName(destinationPath);
+
+    // copy-on-write clone on APFS
+    if (clonefile(source.constData(), destination.constData(), 0) == 0)
+        return true;
+
+    return allowHardLink && ::link(source.constData(), destination.constData()) == 0;
+}
+
 void UBPlatformUtils::hideFile(const QString &filePath)
 {
     FSRef ref;
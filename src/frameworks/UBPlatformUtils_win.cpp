@@ -71,6 +71,17 @@ void UBPlatformUtils::hideFile(const QString &filePath)
     // TODO UB 4.x : hide file from the Windows explorer
 }
 
+bool UBPlatformUtils::linkFile(const QString &sourcePath, const QString &destinationPath, bool allowHardLink)
+{
+    // block cloning is only available on ReFS, a hard link is the only cheap option on NTFS
+    if (!allowHardLink)
+        return false;
+
+    return CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(destinationPath).utf16()),
+                           reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(sourcePath).utf16()),
+                           NULL) != 0;
+}
+
 void UBPlatformUtils::setFileType(const QString &filePath, unsigned long fileType)
 {
     Q_UNUSED(filePath);
@@ -105,7 +105,6 @@ UBFeaturesWidget::UBFeaturesWidget(QWidget *parent, const char *name)
     connect(controller, SIGNAL(scanStarted()), mActionBar, SLOT(lockIt()));
     connect(controller, SIGNAL(scanFinished()), mActionBar, SLOT(unlockIt()));
     connect(controller, SIGNAL(maxFilesCountEvaluated(int)), centralWidget, SIGNAL(maxFilesCountEvaluated(int)));
-    connect(controller, SIGNAL(featureAddedFromThread()), centralWidget, SIGNAL(increaseStatusBarValue()));
     connect(controller, SIGNAL(scanCategory(QString)), centralWidget, SIGNAL(scanCategory(QString)));
     connect(controller, SIGNAL(scanPath(QString)), centralWidget, SIGNAL(scanPath(QString)));
 }
@@ -570,7 +569,6 @@ UBFeaturesCentralWidget::UBFeaturesCentralWidget(QWidget *parent) : QWidget(pare
     mAdditionalDataContainer->setCurrentIndex(ProgressBarWidget);
 
     connect(this, SIGNAL(maxFilesCountEvaluated(int)), progressBar, SLOT(setProgressMax(int)));
-    connect(this, SIGNAL(increaseStatusBarValue()), progressBar, SLOT(increaseProgressValue()));
     connect(this, SIGNAL(scanCategory(QString)), progressBar, SLOT(setCommmonInfoText(QString)));
     connect(this, SIGNAL(scanPath(QString)), progressBar, SLOT(setDetailedInfoText(QString)));
 
@@ -777,11 +775,6 @@ void UBFeaturesProgressInfo::setProgressMin(int pValue)
     mProgressBar->setMinimum(pValue);
 }
 
-void UBFeaturesProgressInfo::increaseProgressValue()
-{
-    mProgressBar->setValue(mProgressBar->value() + 1);
-}
-
 void UBFeaturesProgressInfo::sendFeature(UBFeature pFeature)
 {
     Q_UNUSED(pFeature);
@@ -1257,6 +1250,16 @@ void UBFeaturesModel::addItem( const UBFeature &item )
     endInsertRows();
 }
 
+void UBFeaturesModel::addItems( const QList<UBFeature> &items )
+{
+    if ( items.isEmpty() )
+        return;
+
+    beginInsertRows( QModelIndex(), featuresList->size(), featuresList->size() + items.size() - 1 );
+    featuresList->append( items );
+    endInsertRows();
+}
+
 void UBFeaturesModel::deleteFavoriteItem( const QString &path )
 {
     for ( int i = 0; i < featuresList->size(); ++i )
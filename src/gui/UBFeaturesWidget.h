@@ -237,7 +237,6 @@ signals:
 
 //    progressbar widget related signals
     void maxFilesCountEvaluated(int pValue);
-    void increaseStatusBarValue();
     void scanCategory(const QString &);
     void scanPath(const QString &);
 
@@ -292,7 +291,6 @@ private slots:
     void setDetailedInfoText(const QString &str);
     void setProgressMin(int pValue);
     void setProgressMax(int pValue);
-    void increaseProgressValue();
     void sendFeature(UBFeature pFeature);
 
 
@@ -398,6 +396,7 @@ public:
 
 public slots:
     void addItem( const UBFeature &item );
+    void addItems( const QList<UBFeature> &items );
 
 private:
     QList <UBFeature> *featuresList;
@@ -42,6 +42,9 @@ UBMagnifier::UBMagnifier(QWidget *parent, bool isInteractive)
     , mShouldMoveWidget(false)
     , mShouldResizeWidget(false)
     , borderPen(Qt::darkGray)
+    , mIsMirror(false)
+    , mContentDirty(true)
+    , mRepaintPending(false)
     , gView(0)
     , mView(0)
 {
@@ -95,6 +98,13 @@ UBMagnifier::UBMagnifier(QWidget *parent, bool isInteractive)
     }
 
     connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slot_refresh()));
+
+    // render at most once per frame of the screen, whatever the number of grab requests
+    QScreen *screen = QGuiApplication::primaryScreen();
+    qreal refreshRate = screen ? screen->refreshRate() : 60;
+    mRenderTimer.setSingleShot(true);
+    mRenderTimer.setInterval(qMax(1, qRound(1000 / (refreshRate > 0 ? refreshRate : 60))));
+    connect(&mRenderTimer, SIGNAL(timeout()), this, SLOT(renderContent()));
 }
 
 UBMagnifier::~UBMagnifier()
@@ -178,6 +188,13 @@ void UBMagnifier::createMask()
     pMap = QPixmap(width(), height());
     pMap.fill(Qt::transparent);
     pMap.setMask(bmpMask);
+
+    // show the last content until the next rendering at the new size
+    if (!mContent.isNull())
+        setContent(mContent);
+
+    mContentDirty = true;
+    grabPoint();
 }
 
 void UBMagnifier::setZoom(qreal zoom)
@@ -207,6 +224,8 @@ void UBMagnifier::calculateButtonsPositions()
 void UBMagnifier::paintEvent(QPaintEvent * event)
 {
     Q_UNUSED(event);
+    mRepaintPending = false;
+
     QPainter painter(this);
 
     painter.setRenderHint(QPainter::Antialiasing);
@@ -386,7 +405,38 @@ void UBMagnifier::slot_refresh()
 
 void UBMagnifier::grabPoint()
 {
-    QTransform transM = UBApplication::boardController->controlView()->transform();
+    // a mirror gets its content from the magnifier it is attached to
+    if (mIsMirror)
+        return;
+
+    if (!mRenderTimer.isActive())
+        mRenderTimer.start();
+}
+
+void UBMagnifier::grabPoint(const QPoint &pGrab)
+{
+    updPointGrab = pGrab;
+    grabPoint();
+}
+
+void UBMagnifier::renderContent()
+{
+    if (gView == NULL || updPointGrab.isNull())
+        return;
+
+    UBBoardView *controlView = UBApplication::boardController->controlView();
+    QGraphicsScene *scene = UBApplication::boardController->activeScene().get();
+
+    if (!scene)
+        return;
+
+    if (scene != mContentScene)
+    {
+        mContentScene = scene;
+        mContentDirty = true;
+    }
+
+    QTransform transM = controlView->transform();
     QPointF itemPos = gView->mapFromGlobal(updPointGrab);
 
     qreal zWidth = width() / (params.zoom * transM.m11());
@@ -395,7 +445,7 @@ void UBMagnifier::grabPoint()
     qreal zHeightHalf = zHeight / 2;
 
 
-    QPointF pfScLtF(UBApplication::boardController->controlView()->mapToScene(QPoint(itemPos.x(), itemPos.y())));
+    QPointF pfScLtF(controlView->mapToScene(QPoint(itemPos.x(), itemPos.y())));
 
     float x = pfScLtF.x() - zWidthHalf;
     float y = pfScLtF.y() - zHeightHalf;
@@ -404,53 +454,91 @@ void UBMagnifier::grabPoint()
     QPointF rightBottom(x + zWidth, y + zHeight);
     QRectF srcRect(leftTop, rightBottom);
 
-    QPixmap newPixMap(QSize(width(), height()));
-    QPainter painter(&newPixMap);
+    // the content is rendered once, at the resolution of the biggest magnifier
+    QSize contentSize = size();
+    if (mMirror)
+        contentSize = contentSize.expandedTo(mMirror->size());
+
+    if (contentSize.isEmpty())
+        return;
+
+    // nothing moved in the scene nor under the magnifier, keep the last rendering
+    if (!mContentDirty && srcRect == mContentSourceRect && contentSize == mContent.size())
+        return;
 
-    UBApplication::boardController->activeScene()->render(&painter, QRectF(0,0,width(),height()), srcRect);
+    if (mContent.size() != contentSize)
+        mContent = QImage(contentSize, QImage::Format_ARGB32_Premultiplied);
+
+    mContent.fill(Qt::transparent);
+
+    QPainter painter(&mContent);
+    scene->render(&painter, QRectF(QPointF(0, 0), contentSize), srcRect);
     painter.end();
 
-    pMap.fill(Qt::transparent);
-    pMap = newPixMap.scaled(QSize(width(), height()));
-    pMap.setMask(bmpMask);
+    mContentSourceRect = srcRect;
+    mContentDirty = false;
 
-    update();
+    setContent(mContent);
+
+    if (mMirror)
+        mMirror->setContent(mContent);
 }
 
-void UBMagnifier::grabPoint(const QPoint &pGrab)
+bool UBMagnifier::eventFilter(QObject *object, QEvent *event)
 {
-    QTransform transM = UBApplication::boardController->controlView()->transform();
-    updPointGrab = pGrab;
-    QPointF itemPos = gView->mapFromGlobal(pGrab);
+    // the view repaints the part of the scene that changed, no need to listen to the scene itself
+    QGraphicsView *view = qobject_cast<QGraphicsView*>(gView);
 
-    qreal zWidth = width() / (params.zoom * transM.m11());
-    qreal zWidthHalf = zWidth / 2;
-    qreal zHeight = height() / (params.zoom * transM.m22());
-    qreal zHeightHalf = zHeight / 2;
+    if (event->type() == QEvent::Paint && view && object == view->viewport() && !mIsMirror)
+    {
+        const QRegion& repainted = static_cast<QPaintEvent*>(event)->region();
+        QWidget *viewport = view->viewport();
 
+        // the magnifier is not opaque, repainting it repaints the viewport below it
+        bool ownRepaint = mRepaintPending && isVisible()
+                && QRect(viewport->mapFromGlobal(mapToGlobal(QPoint(0, 0))), size()).contains(repainted.boundingRect());
 
-    QPointF pfScLtF(UBApplication::boardController->controlView()->mapToScene(QPoint(itemPos.x(), itemPos.y())));
+        QRect source = !mContentSourceRect.isNull()
+                ? view->mapFromScene(mContentSourceRect).boundingRect().adjusted(-1, -1, 1, 1)
+                : viewport->rect();
 
-    float x = pfScLtF.x() - zWidthHalf;
-    float y = pfScLtF.y() - zHeightHalf;
+        if (!ownRepaint && repainted.intersects(source))
+        {
+            mContentDirty = true;
+            grabPoint();
+        }
+    }
 
-    QPointF leftTop(x,y);
-    QPointF rightBottom(x + zWidth, y + zHeight);
-    QRectF srcRect(leftTop, rightBottom);
+    return QWidget::eventFilter(object, event);
+}
 
-    QPixmap newPixMap(QSize(width(), height()));
-    QPainter painter(&newPixMap);
+void UBMagnifier::setContent(const QImage &content)
+{
+    if (&content != &mContent)
+        mContent = content;
 
-    UBApplication::boardController->activeScene()->render(&painter, QRectF(0,0,width(),height()), srcRect);
-    painter.end();
+    if (content.size() == size())
+        pMap = QPixmap::fromImage(content);
+    else
+        pMap = QPixmap::fromImage(content.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
 
-   // pMap.fill(Qt::transparent);
-    pMap = newPixMap;
     pMap.setMask(bmpMask);
 
+    mRepaintPending = true;
     update();
 }
 
+void UBMagnifier::setMirror(UBMagnifier *mirror)
+{
+    mMirror = mirror;
+
+    if (mirror)
+        mirror->mIsMirror = true;
+
+    mContentDirty = true;
+    grabPoint();
+}
+
 
 
 // from global
@@ -473,7 +561,16 @@ void UBMagnifier::grabNMove(const QPoint &pGrab, const QPoint &pMove, bool needG
 
 void UBMagnifier::setGrabView(QWidget *view)
 {
+    QAbstractScrollArea *area = qobject_cast<QAbstractScrollArea*>(gView);
+    if (area)
+        area->viewport()->removeEventFilter(this);
+
     gView = view;
+
+    area = qobject_cast<QAbstractScrollArea*>(gView);
+    if (area)
+        area->viewport()->installEventFilter(this);
+
     mRefreshTimer.setInterval(40);
     mRefreshTimer.start();
 }
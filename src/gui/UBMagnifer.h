@@ -32,6 +32,9 @@
 
 #include <QtGui>
 #include <QWidget>
+#include <QPointer>
+
+class QGraphicsScene;
 
 class UBMagnifierParams
 {
@@ -66,6 +69,11 @@ public:
     void setMoveView(QWidget *view) {mView = view;}
     void setDrawingMode(int mode);
 
+    /**
+     * The mirror shows the content rendered by this magnifier instead of rendering the scene itself.
+     */
+    void setMirror(UBMagnifier *mirror);
+
     void grabPoint();
     void grabPoint(const QPoint &point);
     void grabNMove(const QPoint &pGrab, const QPoint &pMove, bool needGrab = true, bool needMove = true);
@@ -83,10 +91,15 @@ signals:
 public slots:
     void slot_refresh();
 
+private slots:
+    void renderContent();
+
 private:
     void calculateButtonsPositions();
+    void setContent(const QImage &content);
 protected:
     void paintEvent(QPaintEvent *);
+    bool eventFilter(QObject *object, QEvent *event);
 
     virtual void mousePressEvent ( QMouseEvent * event );
     virtual void mouseMoveEvent ( QMouseEvent * event );
@@ -117,8 +130,18 @@ private:
     DrawingMode mDrawingMode;
 
     QTimer mRefreshTimer;
+    QTimer mRenderTimer;
     bool m_isInteractive;
 
+    QPointer<UBMagnifier> mMirror;
+    bool mIsMirror;
+
+    QImage mContent;
+    QRectF mContentSourceRect;
+    QPointer<QGraphicsScene> mContentScene;
+    bool mContentDirty;
+    bool mRepaintPending;
+
     QPoint updPointGrab;
     QPoint updPointMove;
     
@@ -41,10 +41,21 @@
 #include "core/memcheck.h"
 
 
+// longest time the mirror may stay without a complete grab, when repaints are not reported
+static const int sFullGrabInterval = 1000;
+
+// slowest refresh rate while the mirrored screen does not change
+static const int sMaxIdleInterval = 500;
+
+
 UBScreenMirror::UBScreenMirror(QWidget* parent)
     : QWidget(parent)
     , mSourceWidget(0)
+    , mGrabCost(0)
+    , mNominalInterval(125)
+    , mInterval(125)
     , mTimerID(0)
+    , mGrabbing(false)
 {
     // NOOP
 }
@@ -64,14 +75,14 @@ void UBScreenMirror::paintEvent(QPaintEvent *event)
 
     painter.fillRect(0, 0, width(), height(), QBrush(Qt::black));
 
-    if (!mLastPixmap.isNull())
+    if (!mFrame.isNull())
     {
         // compute size and offset in device independent coordinates
-        QSizeF pixmapSize = mLastPixmap.size() / mLastPixmap.devicePixelRatioF();
-        int x = (width() - pixmapSize.width()) / 2;
-        int y = (height() - pixmapSize.height()) / 2;
+        QSizeF frameSize = QSizeF(mFrame.size()) / devicePixelRatioF();
+        qreal x = (width() - frameSize.width()) / 2;
+        qreal y = (height() - frameSize.height()) / 2;
 
-        painter.drawPixmap(x, y, mLastPixmap);
+        painter.drawImage(QRectF(QPointF(x, y), frameSize), mFrame);
     }
 }
 
@@ -80,30 +91,235 @@ void UBScreenMirror::timerEvent(QTimerEvent *event)
 {
     Q_UNUSED(event);
 
-    grabPixmap();
+    bool changed = grabPixmap();
 
-    update();
+    adaptInterval(changed);
+
+    if (changed)
+        update();
+}
+
+
+bool UBScreenMirror::eventFilter(QObject *obj, QEvent *event)
+{
+    QWidget* widget = qobject_cast<QWidget*>(obj);
+
+    if (widget && mSourceWidget && (widget == mSourceWidget || mSourceWidget->isAncestorOf(widget)))
+    {
+        switch (event->type())
+        {
+        case QEvent::Paint:
+        {
+            // the repaints done by our own grab are not damages
+            if (mGrabbing)
+                break;
+
+            QRegion region = static_cast<QPaintEvent*>(event)->region();
+
+            if (widget != mSourceWidget)
+                region.translate(widget->mapTo(mSourceWidget, QPoint()));
+
+            mDirtyRegion += region;
+            break;
+        }
+
+        case QEvent::ChildAdded:
+        {
+            QObject* child = static_cast<QChildEvent*>(event)->child();
+
+            if (child->isWidgetType())
+                watch(static_cast<QWidget*>(child));
+
+            break;
+        }
+
+        case QEvent::Resize:
+        case QEvent::Move:
+        case QEvent::Show:
+        case QEvent::Hide:
+            mDirtyRegion += mSourceWidget->rect();
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return QWidget::eventFilter(obj, event);
 }
 
-void UBScreenMirror::grabPixmap()
+
+bool UBScreenMirror::grabPixmap()
 {
     if (mSourceWidget)
     {
-        mLastPixmap = mSourceWidget->grab();
+        return grabSourceWidget();
     }
     else
     {
-        mLastPixmap = UBApplication::displayManager->grab(ScreenRole::Control);
+        return grabScreen();
     }
+}
+
+
+bool UBScreenMirror::grabSourceWidget()
+{
+    QRect sourceRect = mSourceWidget->rect();
+
+    if (updateFrameGeometry(sourceRect.size()) || !mSinceFullGrab.isValid() || mSinceFullGrab.hasExpired(sFullGrabInterval))
+    {
+        // some widgets (e.g. OpenGL based web views) do not always report their repaints
+        mDirtyRegion = sourceRect;
+    }
+
+    // grab one pixel more on each side, so that the smooth scaling does not leave seams
+    QRect dirtyRect = mDirtyRegion.boundingRect().adjusted(-1, -1, 1, 1) & sourceRect;
+    mDirtyRegion = QRegion();
+
+    if (dirtyRect.isEmpty() || mFrame.isNull())
+        return false;
+
+    if (dirtyRect == sourceRect)
+        mSinceFullGrab.start();
 
-    if (!mLastPixmap.isNull())
-        mLastPixmap = mLastPixmap.scaled(size() * mLastPixmap.devicePixelRatioF(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QElapsedTimer grabTimer;
+    grabTimer.start();
+
+    mGrabbing = true;
+    QPixmap pixmap = mSourceWidget->grab(dirtyRect);
+    mGrabbing = false;
+
+    if (pixmap.isNull())
+        return false;
+
+    drawScaled(pixmap, dirtyRect);
+
+    mGrabCost = (3 * mGrabCost + grabTimer.elapsed()) / 4;
+
+    return true;
+}
+
+
+bool UBScreenMirror::grabScreen()
+{
+    // the screen does not report damages, so grab it completely and compare with the last frame
+    QElapsedTimer grabTimer;
+    grabTimer.start();
+
+    QPixmap pixmap = UBApplication::displayManager->grab(ScreenRole::Control);
+
+    if (pixmap.isNull())
+        return false;
+
+    QSizeF sourceSize = QSizeF(pixmap.size()) / pixmap.devicePixelRatioF();
+    bool resized = updateFrameGeometry(sourceSize.toSize());
+
+    if (mFrame.isNull())
+        return false;
+
+    QImage lastFrame = mFrame;
+
+    drawScaled(pixmap, QRectF(QPointF(), sourceSize));
+
+    mGrabCost = (3 * mGrabCost + grabTimer.elapsed()) / 4;
+
+    return resized || mFrame != lastFrame;
+}
+
+
+bool UBScreenMirror::updateFrameGeometry(const QSize& sourceSize)
+{
+    QSize frameSize = sourceSize.scaled(size() * devicePixelRatioF(), Qt::KeepAspectRatio);
+
+    if (sourceSize == mSourceSize && frameSize == mFrame.size())
+        return false;
+
+    mSourceSize = sourceSize;
+
+    if (frameSize.isEmpty())
+    {
+        mFrame = QImage();
+        return true;
+    }
+
+    mFrame = QImage(frameSize, QImage::Format_RGB32);
+    mFrame.fill(Qt::black);
+
+    // the scaling is computed once per source and mirror size and applied to every grabbed area
+    mSourceTransform = QTransform::fromScale(qreal(frameSize.width()) / sourceSize.width(),
+                                             qreal(frameSize.height()) / sourceSize.height());
+
+    return true;
+}
+
+
+void UBScreenMirror::drawScaled(const QPixmap& pixmap, const QRectF& sourceRect)
+{
+    QPainter painter(&mFrame);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setTransform(mSourceTransform);
+    painter.drawPixmap(sourceRect, pixmap, QRectF(pixmap.rect()));
+}
+
+
+void UBScreenMirror::adaptInterval(bool changed)
+{
+    // keep grabbing below a quarter of the time and slow down while the screen is static
+    int interval = qMax(mNominalInterval, qRound(4 * mGrabCost));
+
+    if (!changed && !mSourceWidget)
+    {
+        interval = qMax(interval, qMin(2 * mInterval, sMaxIdleInterval));
+    }
+
+    if (interval != mInterval)
+    {
+        mInterval = interval;
+
+        if (mTimerID != 0)
+        {
+            killTimer(mTimerID);
+            mTimerID = startTimer(mInterval);
+        }
+    }
+}
+
+
+void UBScreenMirror::watch(QWidget* widget)
+{
+    widget->installEventFilter(this);
+
+    foreach (QWidget* child, widget->findChildren<QWidget*>())
+    {
+        child->installEventFilter(this);
+    }
+}
+
+
+void UBScreenMirror::unwatch(QWidget* widget)
+{
+    widget->removeEventFilter(this);
+
+    foreach (QWidget* child, widget->findChildren<QWidget*>())
+    {
+        child->removeEventFilter(this);
+    }
 }
 
 
 void UBScreenMirror::setSourceWidget(QWidget *sourceWidget)
 {
+    if (mSourceWidget)
+        unwatch(mSourceWidget);
+
     mSourceWidget = sourceWidget;
+    mSourceSize = QSize();
+    mDirtyRegion = QRegion();
+    mSinceFullGrab.invalidate();
+    mGrabCost = 0;
+
+    if (mSourceWidget)
+        watch(mSourceWidget);
 
     grabPixmap();
 
@@ -119,14 +335,15 @@ void UBScreenMirror::start()
     {
         int ms = 125;
 
-        bool success;
-        int fps = UBSettings::settings()->mirroringRefreshRateInFps->get().toInt(&success);
+        int fps = UBSettings::settings()->mirroringRefreshRateInFps->getInt();
 
-        if (success && fps > 0)
+        if (fps > 0)
         {
             ms = 1000 / fps;
         }
 
+        mNominalInterval = ms;
+        mInterval = ms;
         mTimerID = startTimer(ms);
     }
     else
@@ -32,6 +32,7 @@
 
 #include <QtGui>
 #include <QWidget>
+#include <QPointer>
 
 class UBScreenMirror : public QWidget
 {
@@ -43,6 +44,7 @@ class UBScreenMirror : public QWidget
 
         virtual void paintEvent (QPaintEvent * event);
         virtual void timerEvent(QTimerEvent *event);
+        virtual bool eventFilter(QObject *obj, QEvent *event);
 
     public slots:
 
@@ -54,14 +56,37 @@ class UBScreenMirror : public QWidget
 
     private:
 
-        void grabPixmap();
+        bool grabPixmap();
+        bool grabSourceWidget();
+        bool grabScreen();
 
-        QWidget* mSourceWidget;
+        bool updateFrameGeometry(const QSize& sourceSize);
+        void drawScaled(const QPixmap& pixmap, const QRectF& sourceRect);
+        void adaptInterval(bool changed);
 
-        QPixmap mLastPixmap;
+        void watch(QWidget* widget);
+        void unwatch(QWidget* widget);
+
+        QPointer<QWidget> mSourceWidget;
+
+        // last frame, scaled to the mirror size in device pixels
+        QImage mFrame;
+        QSize mSourceSize;
+        QTransform mSourceTransform;
+
+        // source widget areas repainted since the last grab, in source widget coordinates
+        QRegion mDirtyRegion;
+        QElapsedTimer mSinceFullGrab;
+
+        qreal mGrabCost;
+        int mNominalInterval;
+        int mInterval;
 
         long mTimerID;
 
+        // set while the source widget is painted for a grab
+        bool mGrabbing;
+
 };
 
 #endif /* UBSCREENMIRROR_H_ */
@@ -57,6 +57,13 @@ UBHttpGet::~UBHttpGet()
         mReply->abort();
                 delete mReply;
     }
+
+    if (mDownloadFile.isOpen())
+    {
+        // interrupted download
+        mDownloadFile.close();
+        QFile::remove(mDownloadFilePath);
+    }
 }
 
 QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackground)
@@ -73,6 +80,18 @@ QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackg
 
     mDownloadedBytes.clear();
 
+    if (!mDownloadFilePath.isEmpty())
+    {
+        // a redirection restarts the download from scratch
+        mDownloadFile.close();
+        mDownloadFile.setFileName(mDownloadFilePath);
+
+        if (!mDownloadFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            qWarning() << "cannot open download file" << mDownloadFilePath << mDownloadFile.errorString();
+        }
+    }
+
     connect(mReply, SIGNAL(finished()), this, SLOT(requestFinished()));
     connect(mReply, SIGNAL(readyRead()), this, SLOT(readyRead()));
     connect(mReply, SIGNAL(downloadProgress(qint64, qint64)), this, SLOT(downloadProgressed(qint64, qint64)));
@@ -82,8 +101,21 @@ QNetworkReply* UBHttpGet::get(QUrl pUrl, QPointF pPos, QSize pSize, bool isBackg
 
 void UBHttpGet::readyRead()
 {
-        if (mReply)
-                mDownloadedBytes += mReply->readAll();
+    if (!mReply)
+        return;
+
+    if (mDownloadFile.isOpen())
+    {
+        if (mDownloadFile.write(mReply->readAll()) == -1)
+        {
+            qWarning() << "cannot write download file" << mDownloadFilePath << mDownloadFile.errorString();
+            mReply->abort();
+        }
+    }
+    else if (mDownloadFilePath.isEmpty())
+    {
+        mDownloadedBytes += mReply->readAll();
+    }
 }
 
 
@@ -94,12 +126,18 @@ void UBHttpGet::requestFinished()
         return;
     }
 
-    if (mReply->error() != QNetworkReply::NoError)
+    if (mReply->error() != QNetworkReply::NoError || (!mDownloadFilePath.isEmpty() && !mDownloadFile.isOpen()))
     {
         qWarning() << mReply->url().toString().left(255) << "get finished with error : " << mReply->error();
 
         mDownloadedBytes.clear();
 
+        if (!mDownloadFilePath.isEmpty())
+        {
+            mDownloadFile.close();
+            QFile::remove(mDownloadFilePath);
+        }
+
         mRedirectionCount = 0;
 
         emit downloadFinished(false, mReply->url(), mReply->errorString(), mDownloadedBytes, mPos, mSize, mIsBackground);
@@ -119,6 +157,13 @@ void UBHttpGet::requestFinished()
 
         mRedirectionCount = 0;
 
+        if (mDownloadFile.isOpen())
+        {
+            // the reply may still hold data not delivered through readyRead
+            mDownloadFile.write(mReply->readAll());
+            mDownloadFile.close();
+        }
+
         emit downloadFinished(true, mReply->url(), mReply->header(QNetworkRequest::ContentTypeHeader).toString(),
                         mDownloadedBytes, mPos, mSize, mIsBackground);
     }
@@ -44,6 +44,10 @@ class UBHttpGet : public QObject
         virtual ~UBHttpGet();
 
         QNetworkReply* get(QUrl pUrl, QPointF pPoint = QPointF(0, 0), QSize pSize = QSize(0, 0), bool isBackground = false);
+
+        // when set, the payload is written to this file as it arrives and downloadFinished carries no data
+        void setDownloadFilePath(const QString& pFilePath) { mDownloadFilePath = pFilePath; }
+        QString downloadFilePath() const { return mDownloadFilePath; }
 //        QNetworkReply* get(const sDownloadFileDesc &downlinfo);
 
     signals:
@@ -63,6 +67,8 @@ class UBHttpGet : public QObject
     private:
 
         QByteArray mDownloadedBytes;
+        QString mDownloadFilePath;
+        QFile mDownloadFile;
         QNetworkReply* mReply;
         QPointF mPos;
         QSize mSize;
@@ -36,6 +36,7 @@
 
 #include "core/memcheck.h"
 #include "core/UBSettings.h"
+#include "core/UBTrace.h"
 
 
 QAtomicInt XPDFRenderer::sInstancesCount = 0;
@@ -381,6 +382,8 @@ QImage& XPDFRenderer::createPDFImageCached(int pageNumber, PdfZoomCacheData &cac
     {
         if (cacheData.requireUpdateImage(pageNumber) && !cacheData.hasToBeProcessed)
         {
+            UBTrace::count("pdf.cache_miss");
+
             mSliceX = 0.;
             mSliceY = 0.;
 
@@ -398,6 +401,10 @@ QImage& XPDFRenderer::createPDFImageCached(int pageNumber, PdfZoomCacheData &cac
             // Start the job multithreaded. The item will be refreshed when the signal 'finished' is emitted.
             m_cacheThread.start();
         }
+        else
+        {
+            UBTrace::count("pdf.cache_hit");
+        }
     } else {
         cacheData.cachedImage = QImage();
     }
@@ -407,10 +414,13 @@ QImage& XPDFRenderer::createPDFImageCached(int pageNumber, PdfZoomCacheData &cac
 
 void XPDFRenderer::CacheThread::run()
 {
+    UB_TRACE_SCOPE("pdf", "renderPage");
+
     m_jobMutex.lock();
 
     CacheThread::JobData jobData = m_nextJob.first();
     m_nextJob.pop_front();
+    UBTrace::count("pdf.cache_queue", -1);
     /* qDebug() << "XPDFRenderer::CacheThread starting page" << jobData.pageNumber
              << "ratio" << jobData.cacheData->ratio; */
 
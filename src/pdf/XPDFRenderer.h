@@ -37,6 +37,7 @@
 #include <splash/SplashBitmap.h>
 
 #include "globals/UBGlobals.h"
+#include "core/UBTrace.h"
 
 #include <poppler/Object.h>
 #include <poppler/GlobalParams.h>
@@ -135,11 +136,12 @@ class XPDFRenderer : public PDFRenderer
             void pushJob(JobData &jobData) {               
                 QMutexLocker lock(&m_jobMutex);
                 m_nextJob.push_back(jobData);
+                UBTrace::count("pdf.cache_queue");
             }
 
             virtual void run() override;
             bool isJobPending() { QMutexLocker lock(&m_jobMutex); return m_nextJob.size() > 0; }
-            void cancelPending() { QMutexLocker lock(&m_jobMutex); m_nextJob.clear(); }
+            void cancelPending() { QMutexLocker lock(&m_jobMutex); UBTrace::count("pdf.cache_queue", -m_nextJob.size()); m_nextJob.clear(); }
         private:
             QList<JobData> m_nextJob;
             QMutex m_jobMutex;
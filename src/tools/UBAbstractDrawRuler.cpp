@@ -126,6 +126,15 @@ QFont UBAbstractDrawRuler::font() const
     return font;
 }
 
+QString UBAbstractDrawRuler::layerKey()
+{
+    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
+    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
+
+    // colors follow the background, graduations follow the grid
+    return QString("%1|%2").arg(scene()->isDarkBackground()).arg(sPixelsPerCentimeter);
+}
+
 void UBAbstractDrawRuler::StartLine(const QPointF& position, qreal width)
 {
     Q_UNUSED(position);
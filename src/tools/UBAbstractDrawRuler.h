@@ -33,6 +33,7 @@
 #include <QtGui>
 #include <QGraphicsItem>
 #include "frameworks/UBGeometryUtils.h"
+#include "tools/UBToolLayerCache.h"
 
 class UBGraphicsScene;
 class QGraphicsSvgItem;
@@ -80,6 +81,7 @@ protected:
     QColor  middleFillColor() const;
     QColor  edgeFillColor() const;
     QFont   font() const;
+    QString layerKey();
 
     static const QColor sLightBackgroundEdgeFillColor;
     static const QColor sLightBackgroundMiddleFillColor;
@@ -95,6 +97,8 @@ protected:
     static const int sDrawTransparency;
     static const int sRoundingRadius;
     qreal sPixelsPerCentimeter;
+
+    UBToolLayerCache mLayerCache;
 };
 
 #endif
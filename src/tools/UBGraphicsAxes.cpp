@@ -170,29 +170,36 @@ void UBGraphicsAxes::paint(QPainter *painter, const QStyleOptionGraphicsItem *st
     else
         mMoveToolSvgItem->setVisible(false);
 
-    QTransform antiScaleTransform2;
-    qreal ratio = mAntiScaleRatio > 1.0 ? mAntiScaleRatio : 1.0;
-    antiScaleTransform2.scale(ratio, 1.0);
-
-    QPen pen(drawColor());
-    pen.setWidthF(2);
-    painter->setPen(pen);
-    painter->setRenderHint(QPainter::Antialiasing, true);
-    painter->drawLine(xAxis());
-    painter->drawLine(yAxis());
-
-    // draw arrows at end
-    QPointF tip = xAxis().p2();
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() + sArrowWidth);
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() - sArrowWidth);
-
-    tip = yAxis().p2();
-    painter->drawLine(tip.x(), tip.y(), tip.x() + sArrowWidth, tip.y() + sArrowLength);
-    painter->drawLine(tip.x(), tip.y(), tip.x() - sArrowWidth, tip.y() + sArrowLength);
+    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
+    mPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
 
-    pen.setWidthF(1);
-    painter->setPen(pen);
-    paintGraduations(painter);
+    // the axes only change with the bounds, the grid and the background
+    QString key = QString("%1,%2,%3,%4|%5|%6|%7")
+            .arg(mBounds.x()).arg(mBounds.y()).arg(mBounds.width()).arg(mBounds.height())
+            .arg(mShowNumbers)
+            .arg(mPixelsPerCentimeter)
+            .arg(drawColor().name(QColor::HexArgb));
+
+    mLayerCache.paint(painter, boundingRect().adjusted(-sArrowWidth, -sArrowWidth, sArrowWidth, sArrowWidth), key, [this](QPainter* layerPainter) {
+        QPen pen(drawColor());
+        pen.setWidthF(2);
+        layerPainter->setPen(pen);
+        layerPainter->drawLine(xAxis());
+        layerPainter->drawLine(yAxis());
+
+        // draw arrows at end
+        QPointF tip = xAxis().p2();
+        layerPainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() + sArrowWidth);
+        layerPainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowLength, tip.y() - sArrowWidth);
+
+        tip = yAxis().p2();
+        layerPainter->drawLine(tip.x(), tip.y(), tip.x() + sArrowWidth, tip.y() + sArrowLength);
+        layerPainter->drawLine(tip.x(), tip.y(), tip.x() - sArrowWidth, tip.y() + sArrowLength);
+
+        pen.setWidthF(1);
+        layerPainter->setPen(pen);
+        paintGraduations(layerPainter);
+    });
 }
 
 
@@ -213,9 +220,6 @@ void UBGraphicsAxes::paintGraduations(QPainter *painter)
     painter->setFont(font());
     QFontMetricsF fontMetrics(painter->font());
 
-    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
-    mPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
-
     // When a "centimeter" is too narrow, we only display every 5th number
     double numbersWidth = fontMetrics.boundingRect("-00").width();
     bool shouldDisplayAllNumbers = (numbersWidth <= (mPixelsPerCentimeter - 5));
@@ -36,6 +36,7 @@
 
 #include "core/UB.h"
 #include "domain/UBItem.h"
+#include "tools/UBToolLayerCache.h"
 
 class UBGraphicsScene;
 
@@ -124,6 +125,8 @@ class UBGraphicsAxes : public QObject, public QGraphicsPolygonItem, public UBIte
         qreal mPixelsPerCentimeter;
         QRectF mBounds;
 
+        UBToolLayerCache mLayerCache;
+
         // Constants
         static const QRect     sDefaultRect;
 
@@ -108,7 +108,6 @@ void UBGraphicsProtractor::paint(QPainter *painter, const QStyleOptionGraphicsIt
 
     painter->setFont(QFont("Arial", 11));
     painter->setBrush(fillBrush());
-    painter->drawPie(QRectF(rect().center().x() - radius(), rect().center().y() - radius(), 2 * radius(), 2 * radius()), mStartAngle * 16, mSpan * 16);
     paintGraduations(painter);
     paintButtons(painter);
     paintHelp(painter);
@@ -453,69 +452,128 @@ QRectF UBGraphicsProtractor::markerButtonRect () const
 
 void UBGraphicsProtractor::paintGraduations(QPainter *painter)
 {
+    QPointF center = rect().center();
+    qreal rad = radius();
+
+    // The pie and the graduation marks are cached unrotated: rotating the protractor
+    // only rotates the layer. The labels stay horizontal and are drawn on top.
+    QString key = QString("%1|%2|%3|%4,%5")
+            .arg(scene()->isDarkBackground())
+            .arg(rad)
+            .arg(mSpan)
+            .arg(center.x()).arg(center.y());
+
+    QPen pen = painter->pen();
+    QBrush brush = painter->brush();
+
     painter->save();
+    painter->translate(center);
+    painter->rotate(-mStartAngle);
+    painter->translate(-center.x(), -center.y());
 
+    mLayerCache.paint(painter, QRectF(center.x() - rad - 1, center.y() - rad - 1, 2 * rad + 2, 2 * rad + 2), key,
+                      [this, pen, brush](QPainter* layerPainter) {
+        layerPainter->setPen(pen);
+        layerPainter->setBrush(brush);
+        paintGraduationMarks(layerPainter);
+    });
+
+    painter->restore();
+
+    paintGraduationLabels(painter);
+}
+
+void UBGraphicsProtractor::paintGraduationMarks(QPainter *painter)
+{
     const int  tenDegreeGraduationLength = 22;
     const int fiveDegreeGraduationLength = 15;
     const int  oneDegreeGraduationLength = 7;
 
+    qreal rad = radius();
+
+    QPointF center = rect().center();
+    painter->drawPie(QRectF(center.x() - rad, center.y() - rad, 2 * rad, 2 * rad), 0, mSpan * 16);
+    painter->drawArc(QRectF(center.x() - rad/2, center.y() - rad/2, rad, rad), 0, mSpan*16);
+
+    for (int angle = 1; angle < mSpan; angle++)
+    {
+        int graduationLength = (0 == angle % 10) ? tenDegreeGraduationLength : ((0 == angle % 5) ? fiveDegreeGraduationLength : oneDegreeGraduationLength);
+        qreal co = cos(((qreal)angle) * PI/180);
+        qreal si = sin(((qreal)angle) * PI/180);
+        if (0 == angle % 90)
+            painter->drawLine(QLineF(QPointF(center.x(), center.y()),
+                        QPointF(center.x() + co*tenDegreeGraduationLength, center.y() - si*tenDegreeGraduationLength)));
+
+        //external arc
+        painter->drawLine(QLineF(QPointF(center.x()+ rad*co, center.y() - rad*si),
+                                 QPointF(center.x()+ (rad - graduationLength)*co, center.y() - (rad - graduationLength)*si)));
+        //internal arc
+        painter->drawLine(QLineF(QPointF(center.x()+ rad/2*co, center.y() - rad/2*si),
+                                 QPointF(center.x()+ (rad/2 + graduationLength)*co,
+                                         center.y() - (rad/2 + graduationLength)*si)));
+    }
+}
+
+void UBGraphicsProtractor::paintGraduationLabels(QPainter *painter)
+{
+    painter->save();
+
+    const int  tenDegreeGraduationLength = 22;
+
     QFont font1 = painter->font();
 
 #ifdef Q_OS_OSX
     font1.setPointSizeF(font1.pointSizeF() + 3);
     font1.setWeight(QFont::Thin);
 #endif
-    QFontMetricsF fm1(font1);
 
     //Font for internal arc
     QFont font2 = painter->font();
     font2.setPointSizeF(font1.pointSizeF()/1.5);
-    QFontMetricsF fm2(font2);
 
-    qreal rad = radius();
+    if (font1 != mLabelFont)
+    {
+        // laid out once, the labels are the same for every paint
+        mExternalLabels.clear();
+        mInternalLabels.clear();
+        mLabelFont = font1;
+    }
 
+    qreal rad = radius();
     QPointF center = rect().center();
-    painter->drawArc(QRectF(center.x() - rad/2, center.y() - rad/2, rad, rad), mStartAngle*16, mSpan*16);
 
-    for (int angle = 1; angle < mSpan; angle++)
+    for (int angle = 10; angle < mSpan; angle += 10)
     {
-        int graduationLength = (0 == angle % 10) ? tenDegreeGraduationLength : ((0 == angle % 5) ? fiveDegreeGraduationLength : oneDegreeGraduationLength);
         qreal co = cos(((qreal)angle + mStartAngle) * PI/180);
         qreal si = sin(((qreal)angle + mStartAngle) * PI/180);
-        if (0 == angle % 90)
-            painter->drawLine(QLineF(QPointF(center.x(), center.y()), 
-                        QPointF(center.x() + co*tenDegreeGraduationLength, center.y() - si*tenDegreeGraduationLength)));
 
         //external arc
-        painter->drawLine(QLineF(QPointF(center.x()+ rad*co, center.y() - rad*si),
-                                 QPointF(center.x()+ (rad - graduationLength)*co, center.y() - (rad - graduationLength)*si)));
+        painter->setFont(font1);
+        const QStaticText& grad = graduationLabel(mExternalLabels, angle, font1);
+        painter->drawStaticText(QPointF(center.x() + (rad - tenDegreeGraduationLength*1.5)*co - grad.size().width()/2,
+                                        center.y() - (rad - tenDegreeGraduationLength*1.5)*si - grad.size().height()/2), grad);
+
         //internal arc
-        painter->drawLine(QLineF(QPointF(center.x()+ rad/2*co, center.y() - rad/2*si),
-                                 QPointF(center.x()+ (rad/2 + graduationLength)*co,
-                                         center.y() - (rad/2 + graduationLength)*si)));
+        painter->setFont(font2);
+        const QStaticText& grad2 = graduationLabel(mInternalLabels, (int)(mSpan - angle), font2);
+        painter->drawStaticText(QPointF(center.x() + (rad/2 + tenDegreeGraduationLength*1.5)*co - grad2.size().width()/2,
+                                        center.y() - (rad/2 + tenDegreeGraduationLength*1.5)*si - grad2.size().height()/2), grad2);
+    }
 
-        if (0 == angle % 10)
-        {
-            //external arc
-            painter->setFont(font1);
-            QString grad = QString("%1").arg((int)(angle));
-            QString grad2 = QString("%1").arg((int)(mSpan - angle));
-
-            painter->drawText(QRectF(center.x() + (rad - graduationLength*1.5)*co  - fm1.horizontalAdvance(grad)/2,
-                                     center.y() - (rad - graduationLength*1.5)*si - fm1.height()/2,
-                                     fm1.horizontalAdvance(grad), fm1.height()), Qt::AlignTop, grad);
-
-            //internal arc
-            painter->setFont(font2);
-            painter->drawText(QRectF(center.x() + (rad/2 + graduationLength*1.5)*co  - fm2.horizontalAdvance(grad2)/2,
-                                     center.y() - (rad/2 + graduationLength*1.5)*si - fm2.height()/2,
-                                     fm2.horizontalAdvance(grad2), fm2.height()), Qt::AlignTop, grad2);
-            painter->setFont(font1);
+    painter->restore();
+}
 
-        }
+const QStaticText& UBGraphicsProtractor::graduationLabel(QHash<int, QStaticText>& labels, int value, const QFont& font)
+{
+    if (!labels.contains(value))
+    {
+        QStaticText label(QString("%1").arg(value));
+        label.setTextFormat(Qt::PlainText);
+        label.prepare(QTransform(), font);
+        labels.insert(value, label);
     }
 
-    painter->restore();
+    return labels[value];
 }
 
 void UBGraphicsProtractor::paintHelp(QPainter *painter)
@@ -90,6 +90,9 @@ class UBGraphicsProtractor : public UBAbstractDrawRuler, public QGraphicsEllipse
         // Helpers
         void paintButtons (QPainter *painter);
         void paintAngleMarker (QPainter *painter);
+        void paintGraduationMarks (QPainter *painter);
+        void paintGraduationLabels (QPainter *painter);
+        const QStaticText& graduationLabel (QHash<int, QStaticText>& labels, int value, const QFont& font);
         Tool toolFromPos (QPointF pos);
         qreal antiScale () const;
         std::shared_ptr<UBGraphicsScene>            scene() const;
@@ -122,6 +125,10 @@ class UBGraphicsProtractor : public UBAbstractDrawRuler, public QGraphicsEllipse
         QGraphicsSvgItem* mMarkerSvgItem;
         QGraphicsSvgItem* mRotateSvgItem;
 
+        QFont mLabelFont;
+        QHash<int, QStaticText> mExternalLabels;
+        QHash<int, QStaticText> mInternalLabels;
+
         static const QRectF sDefaultRect;
         static const qreal minRadius;
 
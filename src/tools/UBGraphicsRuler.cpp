@@ -128,17 +128,26 @@ void UBGraphicsRuler::paint(QPainter *painter, const QStyleOptionGraphicsItem *s
 
     mRotateSvgItem->setPos(rotateButtonRect().topLeft());
 
-    QPainterPath outline = QPainterPath();
-    outline.addRoundedRect(rect(), sRoundingRadius, sRoundingRadius);
+    // the body only changes with the size, the grid and the background
+    QString key = QString("%1|%2,%3").arg(layerKey()).arg(rect().x()).arg(rect().y());
+
+    mLayerCache.paint(painter, rect().adjusted(-1, -1, 1, 1), key, [this](QPainter* layerPainter) {
+        QPainterPath outline = QPainterPath();
+        outline.addRoundedRect(rect(), sRoundingRadius, sRoundingRadius);
+
+        layerPainter->setPen(drawColor());
+        layerPainter->setBrush(edgeFillColor());
+
+        fillBackground(layerPainter, outline);
+        drawBorder(layerPainter, outline);
+        paintGraduations(layerPainter);
+    });
 
     painter->setPen(drawColor());
     painter->setBrush(edgeFillColor());
     painter->setRenderHint(QPainter::Antialiasing, true);
 
-    fillBackground(painter, outline);
-    drawBorder(painter, outline);
     paintHelp(painter);
-    paintGraduations(painter);
     if (mRotating)
         paintRotationCenter(painter);
 }
@@ -213,9 +222,6 @@ void UBGraphicsRuler::paintGraduations(QPainter *painter)
     painter->setFont(font());
     QFontMetricsF fontMetrics(painter->font());
 
-    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
-    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
-
     qreal pixelsPerMillimeter = sPixelsPerCentimeter/10.0;
     int rulerLengthInMillimeters = (rect().width() - sLeftEdgeMargin - sRoundingRadius)/pixelsPerMillimeter;
 
@@ -306,6 +306,41 @@ void UBGraphicsTriangle::calculatePoints(const QRectF& r)
 }
 
 void UBGraphicsTriangle::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
+{
+    // the body only changes with the geometry, the grid and the background
+    QString key = QString("%1|%2,%3,%4,%5|%6|%7")
+            .arg(layerKey())
+            .arg(rect().x()).arg(rect().y()).arg(rect().width()).arg(rect().height())
+            .arg(mOrientation)
+            .arg(mShouldPaintInnerTriangle);
+
+    mLayerCache.paint(painter, rect().adjusted(-1, -1, 1, 1), key, [this](QPainter* layerPainter) {
+        paintBody(layerPainter);
+        paintGraduations(layerPainter);
+    });
+
+    painter->setPen(drawColor());
+    paintHelp(painter);
+
+    mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
+
+    mCloseSvgItem->setPos(closeButtonRect().topLeft());
+
+    mHFlipSvgItem->setPos(hFlipRect().topLeft());
+    mVFlipSvgItem->setPos(vFlipRect().topLeft());
+    mRotateSvgItem->setPos(rotateRect().topLeft());
+
+    if (mShowButtons || mResizing1 || mResizing2)
+    {
+        painter->setBrush(QColor(0, 0, 0));
+        if (mShowButtons || mResizing1)
+            painter->drawPolygon(resize1Polygon());
+        if (mShowButtons || mResizing2)
+            painter->drawPolygon(resize2Polygon());
+    }
+}
+
+void UBGraphicsTriangle::paintBody(QPainter *painter)
 {
     painter->setPen(Qt::NoPen);
 
@@ -361,30 +396,6 @@ void UBGraphicsTriangle::paint(QPainter *painter, const QStyleOptionGraphicsItem
         painter->drawPolygon(polygon);
         polygon.clear();
     }
-
-
-    paintGraduations(painter);
-    paintHelp(painter);
-
-    mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
-
-    mCloseSvgItem->setPos(closeButtonRect().topLeft());
-
-    //qDebug() << "UBGraphicsTriangle Paint"<<"closeButtonRect().topLeft()="
-    //<<closeButtonRect().topLeft();
-
-    mHFlipSvgItem->setPos(hFlipRect().topLeft());
-    mVFlipSvgItem->setPos(vFlipRect().topLeft());
-    mRotateSvgItem->setPos(rotateRect().topLeft());
-
-    if (mShowButtons || mResizing1 || mResizing2)
-    {
-        painter->setBrush(QColor(0, 0, 0));
-        if (mShowButtons || mResizing1)
-            painter->drawPolygon(resize1Polygon());
-        if (mShowButtons || mResizing2)
-            painter->drawPolygon(resize2Polygon());
-    }
 }
 
 QPainterPath UBGraphicsTriangle::shape() const
@@ -478,8 +489,6 @@ void UBGraphicsTriangle::paintGraduations(QPainter *painter)
     painter->setFont(font());
     QFontMetricsF fontMetrics(painter->font());
 
-    // Update the width of one "centimeter" to correspond to the width of the background grid (whether it is displayed or not)
-    sPixelsPerCentimeter = UBApplication::boardController->activeScene()->backgroundGridSize();
     double pixelsPerMillimeter = sPixelsPerCentimeter/10.0;
 
     // When a "centimeter" is too narrow, we only display every 5th number, and every 5th millimeter mark
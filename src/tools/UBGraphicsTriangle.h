@@ -156,6 +156,8 @@ class UBGraphicsTriangle : public UBAbstractDrawRuler, public QGraphicsPolygonIt
 
     private:
 
+        void paintBody(QPainter *painter);
+
         QCursor mResizeCursor1;
         QCursor mResizeCursor2;
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include "UBToolLayerCache.h"
+
+#include <cmath>
+
+#include "core/memcheck.h"
+
+UBToolLayerCache::UBToolLayerCache()
+{
+    // NOOP
+}
+
+UBToolLayerCache::~UBToolLayerCache()
+{
+    clear();
+}
+
+void UBToolLayerCache::paint(QPainter* painter, const QRectF& bounds, const QString& key, std::function<void(QPainter*)> paintLayer)
+{
+    qreal bucket = zoomBucket(painter);
+    QSize pixelSize = (bounds.size() * bucket).toSize() + QSize(1, 1);
+
+    if (bounds.isEmpty() || (qint64)pixelSize.width() * pixelSize.height() > sMaxPixelCount)
+    {
+        // too large to be worth caching (very long tool or deep zoom): paint directly
+        clear();
+        painter->save();
+        paintLayer(painter);
+        painter->restore();
+        return;
+    }
+
+    QString fullKey = QString("%1|%2|%3x%4").arg(key).arg(bucket).arg(bounds.width()).arg(bounds.height());
+
+    QPixmap pixmap;
+
+    if (fullKey != mKey || !QPixmapCache::find(mPixmapKey, &pixmap))
+    {
+        clear();
+
+        pixmap = QPixmap(pixelSize);
+        pixmap.fill(Qt::transparent);
+
+        QPainter layerPainter(&pixmap);
+        layerPainter.setRenderHint(QPainter::Antialiasing, true);
+        layerPainter.setRenderHint(QPainter::TextAntialiasing, true);
+        layerPainter.scale(bucket, bucket);
+        layerPainter.translate(-bounds.topLeft());
+        paintLayer(&layerPainter);
+        layerPainter.end();
+
+        mPixmapKey = QPixmapCache::insert(pixmap);
+        mKey = fullKey;
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(QRectF(bounds.topLeft(), QSizeF(pixmap.size()) / bucket), pixmap, QRectF(pixmap.rect()));
+    painter->restore();
+}
+
+void UBToolLayerCache::clear()
+{
+    if (mPixmapKey.isValid())
+        QPixmapCache::remove(mPixmapKey);
+
+    mPixmapKey = QPixmapCache::Key();
+    mKey.clear();
+}
+
+qreal UBToolLayerCache::zoomBucket(const QPainter* painter)
+{
+    // rotation does not change the scale, so a rotating tool keeps its layer
+    QTransform transform = painter->deviceTransform();
+    qreal scale = qSqrt(qAbs(transform.determinant()));
+
+    if (painter->device())
+        scale *= painter->device()->devicePixelRatioF();
+
+    if (scale <= 0)
+        return 1.0;
+
+    // quarter octave steps, rounded up so the layer is never magnified by more than ~19%
+    return qPow(2.0, qCeil(std::log2(scale) * 4.0) / 4.0);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2015-2022 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * Copyright (C) 2013 Open Education Foundation
+ *
+ * Copyright (C) 2010-2013 Groupement d'Intérêt Public pour
+ * l'Education Numérique en Afrique (GIP ENA)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef UBTOOLLAYERCACHE_H_
+#define UBTOOLLAYERCACHE_H_
+
+#include <QtGui>
+
+#include <functional>
+
+/**
+ * Raster cache for the static part of a drawing tool (body, graduations, labels) or of an
+ * item which is expensive to draw, like a text item which is not edited.
+ *
+ * The layer is rendered once for a given key and zoom bucket and then drawn as a pixmap,
+ * so moving or rotating a tool does not repaint every graduation. The key must describe
+ * everything the layer depends on: geometry, grid size, colors...
+ *
+ * The pixmaps are stored in QPixmapCache, so the memory used by all the layers is bounded
+ * by its limit and an evicted layer is rendered again when it is painted next.
+ */
+class UBToolLayerCache
+{
+    public:
+        UBToolLayerCache();
+        ~UBToolLayerCache();
+
+        void paint(QPainter* painter, const QRectF& bounds, const QString& key, std::function<void(QPainter*)> paintLayer);
+        void clear();
+
+    private:
+        static qreal zoomBucket(const QPainter* painter);
+
+        QPixmapCache::Key mPixmapKey;
+        QString mKey;
+
+        static const int sMaxPixelCount = 1024 * 1024;
+};
+
+#endif /* UBTOOLLAYERCACHE_H_ */